@@ -0,0 +1,254 @@
+#include "asset_loader.h"
+#include <stdexcept>
+
+// Liczba wierszy przesyłanych jednym SDL_UpdateTexture - duży atlas jest
+// rozkładany na kilka klatek zamiast zatrzymać jedną
+#define UPLOAD_ROWS 64
+
+asset_loader_t::asset_loader_t(SDL_Renderer *renderer, int threads)
+        : renderer(renderer), max_size(max_texture_size(renderer)) {
+    // Tekstura zastępcza: jeden szary piksel
+    SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 1, 1);
+    if (!texture) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create placeholder texture: %s", SDL_GetError());
+        throw std::invalid_argument(SDL_GetError());
+    }
+    const Uint32 gray = 0xff404040;
+    SDL_UpdateTexture(texture, NULL, &gray, sizeof(gray));
+    placeholder.reset(texture, SDL_DestroyTexture);
+
+    if (threads < 1) threads = 1;
+    for (int i = 0; i < threads; i++) workers.emplace_back(&asset_loader_t::worker_loop, this);
+}
+
+asset_loader_t::~asset_loader_t() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_cv.notify_all();
+    for (std::thread &worker : workers) worker.join();
+
+    for (job_t *job : requests) free_job(job);
+    for (job_t *job = decoded.exchange(nullptr); job;) {
+        job_t *next = job->next;
+        free_job(job);
+        job = next;
+    }
+    for (job_t *job = upload_head; job;) {
+        job_t *next = job->next;
+        free_job(job);
+        job = next;
+    }
+}
+
+void asset_loader_t::free_job(job_t *job) {
+    if (job->surface) SDL_FreeSurface(job->surface);
+    if (job->texture) SDL_DestroyTexture(job->texture);
+    delete job;
+}
+
+void asset_loader_t::enqueue(job_t *job) {
+    pending_count++;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        requests.push_back(job);
+    }
+    queue_cv.notify_one();
+}
+
+texture_handle_t asset_loader_t::submit(job_t *job) {
+    job->target = std::make_shared<async_texture_t>();
+    job->target->placeholder = placeholder.get();
+    job->target->paths = job->paths;
+    job->target->color_keys = job->color_keys;
+    job->target->atlas = job->atlas;
+    textures.push_back(job->target);
+    enqueue(job);
+    return job->target;
+}
+
+asset_loader_t::job_t *asset_loader_t::atlas_job(const texture_handle_t &target) {
+    job_t *job = new job_t;
+    job->target = target;
+    job->paths = target->paths;
+    job->color_keys = target->color_keys;
+    job->atlas = true;
+    return job;
+}
+
+int asset_loader_t::reload(const std::string &path) {
+    int reloads = 0;
+    for (size_t t = 0; t < textures.size();) {
+        texture_handle_t target = textures[t].lock();
+        if (!target) {
+            // Uchwyt zwolniony - nie ma czego odświeżać
+            textures[t] = textures.back();
+            textures.pop_back();
+            continue;
+        }
+        t++;
+        for (size_t i = 0; i < target->paths.size(); i++) {
+            if (target->paths[i] != path) continue;
+            job_t *job = new job_t;
+            job->target = target;
+            job->paths.push_back(path);
+            job->color_keys.push_back(target->color_keys[i]);
+            if (target->atlas) job->patch_index = (int) i;
+            enqueue(job);
+            reloads++;
+            break;
+        }
+    }
+    return reloads;
+}
+
+texture_handle_t asset_loader_t::load_image(const char *path, bool color_key) {
+    job_t *job = new job_t;
+    job->paths.push_back(path);
+    job->color_keys.push_back(color_key);
+    return submit(job);
+}
+
+texture_handle_t asset_loader_t::load_atlas(const std::vector<atlas_image_t> &images) {
+    job_t *job = new job_t;
+    for (const atlas_image_t &image : images) {
+        job->paths.push_back(image.path);
+        job->color_keys.push_back(image.color_key);
+    }
+    job->atlas = true;
+    return submit(job);
+}
+
+void asset_loader_t::decode(job_t *job) {
+    try {
+        if (job->atlas) {
+            std::vector<atlas_image_t> images;
+            for (size_t i = 0; i < job->paths.size(); i++) images.push_back({job->paths[i].c_str(), job->color_keys[i] != 0});
+            job->surface = pack_atlas_surface(images, max_size, job->rects);
+        } else {
+            job->surface = load_image_surface(job->paths[0].c_str(), job->color_keys[0] != 0);
+            job->rects.push_back({0, 0, job->surface->w, job->surface->h});
+        }
+    } catch (const std::exception &) {
+        job->failed = true; // błąd już zapisany w logu
+    }
+}
+
+void asset_loader_t::worker_loop() {
+    for (;;) {
+        job_t *job;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_cv.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping) return;
+            job = requests.front();
+            requests.pop_front();
+        }
+        decode(job);
+
+        job->next = decoded.load(std::memory_order_relaxed);
+        while (!decoded.compare_exchange_weak(job->next, job, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+}
+
+// Wstawia obraz w jego miejsce w gotowym atlasie; false, gdy atlasu jeszcze
+// nie ma albo obraz zmienił rozmiar i atlas trzeba ułożyć od nowa
+bool asset_loader_t::patch_atlas(job_t *job) {
+    async_texture_t &target = *job->target;
+    if (!target.loaded || (size_t) job->patch_index >= target.rects.size()) return false;
+    const SDL_Rect &slot = target.rects[job->patch_index];
+    if (slot.w != job->surface->w || slot.h != job->surface->h) return false;
+    if (SDL_UpdateTexture(target.loaded.get(), &slot, job->surface->pixels, job->surface->pitch)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't upload texture: %s", SDL_GetError());
+    }
+    return true;
+}
+
+// Jeden pas wierszy; true, gdy tekstura jest kompletna albo zadanie się nie powiodło
+bool asset_loader_t::upload_step(job_t *job) {
+    if (job->failed) return true;
+    if (job->patch_index >= 0) {
+        // Jeden obraz atlasu jest mały - przesyłany od razu w całości
+        if (!patch_atlas(job)) {
+            SDL_Log("%s changed size, repacking atlas", job->paths[0].c_str());
+            enqueue(atlas_job(job->target));
+        }
+        return true;
+    }
+    SDL_Surface *surface = job->surface;
+    if (!job->texture) {
+        job->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, surface->w, surface->h);
+        if (!job->texture) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture: %s", SDL_GetError());
+            job->failed = true;
+            return true;
+        }
+        SDL_SetTextureBlendMode(job->texture, SDL_BLENDMODE_BLEND);
+    }
+
+    int rows = surface->h - job->rows_uploaded;
+    if (rows > UPLOAD_ROWS) rows = UPLOAD_ROWS;
+    SDL_Rect band = {0, job->rows_uploaded, surface->w, rows};
+    const Uint8 *pixels = (const Uint8 *) surface->pixels + (size_t) job->rows_uploaded * surface->pitch;
+    if (SDL_UpdateTexture(job->texture, &band, pixels, surface->pitch)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't upload texture: %s", SDL_GetError());
+        job->failed = true;
+        return true;
+    }
+    job->rows_uploaded += rows;
+    return job->rows_uploaded >= surface->h;
+}
+
+int asset_loader_t::process_uploads(double budget_ms) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 budget = (Uint64) (budget_ms * (double) SDL_GetPerformanceFrequency() / 1000.0);
+
+    // Gotowe powierzchnie ze stosu, odwrócone do kolejności ukończenia
+    job_t *reversed = nullptr;
+    for (job_t *job = decoded.exchange(nullptr, std::memory_order_acquire); job;) {
+        job_t *next = job->next;
+        job->next = reversed;
+        reversed = job;
+        job = next;
+    }
+    for (job_t *job = reversed; job;) {
+        job_t *next = job->next;
+        job->next = nullptr;
+        if (upload_tail) upload_tail->next = job;
+        else upload_head = job;
+        upload_tail = job;
+        job = next;
+    }
+
+    int completed = 0;
+    while (upload_head) {
+        job_t *job = upload_head;
+        if (upload_step(job)) {
+            async_texture_t &target = *job->target;
+            if (job->failed) {
+                // Nieudane odświeżenie zostawia poprzednią wersję
+                if (!target.loaded) target.load_failed = true;
+            } else if (job->patch_index >= 0) {
+                completed++;
+            } else {
+                target.loaded.reset(job->texture, SDL_DestroyTexture);
+                target.rects = std::move(job->rects);
+                job->texture = nullptr;
+                completed++;
+            }
+            upload_head = job->next;
+            if (!upload_head) upload_tail = nullptr;
+            free_job(job);
+            pending_count--;
+        }
+        if (SDL_GetPerformanceCounter() - start >= budget) break;
+    }
+    return completed;
+}
+
+void asset_loader_t::finish() {
+    while (pending_count > 0) {
+        if (process_uploads(1000.0) == 0 && !upload_head) SDL_Delay(1);
+    }
+}
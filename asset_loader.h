@@ -0,0 +1,131 @@
+#ifndef MYGAME_ASSET_LOADER_H
+#define MYGAME_ASSET_LOADER_H
+
+#include "SDL2/SDL.h"
+#include "render.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Tekstura wczytywana w tle. Uchwyt można używać od razu: dopóki piksele nie
+// zostaną przesłane, texture() zwraca teksturę zastępczą, a rect() jej
+// prostokąt, więc rysowanie działa bez sprawdzania stanu. Po błędzie
+// wczytywania zostaje tekstura zastępcza.
+class async_texture_t {
+public:
+    SDL_Texture *texture() const { return loaded ? loaded.get() : placeholder; }
+
+    // Położenie i-tego obrazu w teksturze (dla atlasu z asset_loader_t::load_atlas)
+    const SDL_Rect &rect(int index) const { return loaded ? rects[index] : placeholder_rect; }
+
+    bool ready() const { return (bool) loaded; }
+    bool failed() const { return load_failed; }
+
+private:
+    friend class asset_loader_t;
+
+    SDL_Texture *placeholder = nullptr;
+    SDL_Rect placeholder_rect = {0, 0, 1, 1};
+    std::shared_ptr<SDL_Texture> loaded;
+    std::vector<SDL_Rect> rects;
+    bool load_failed = false;
+
+    // Źródła tekstury - do ponownego wczytania (asset_loader_t::reload)
+    std::vector<std::string> paths;
+    std::vector<char> color_keys;
+    bool atlas = false;
+};
+
+typedef std::shared_ptr<async_texture_t> texture_handle_t;
+
+// Wczytywanie obrazów bez zatrzymywania klatek. Wątki robocze dekodują pliki
+// (SDL_LoadBMP_RW, konwersja, pakowanie atlasu) do powierzchni i odkładają je
+// na bezblokadowy stos. Wątek gry w process_uploads() zdejmuje gotowe
+// powierzchnie i przesyła je do tekstur pasami wierszy, dopóki nie wyczerpie
+// budżetu czasu klatki. Metody wywołuje wątek, który utworzył renderer.
+class asset_loader_t {
+public:
+    // Rzuca std::invalid_argument, gdy nie da się utworzyć tekstury zastępczej
+    explicit asset_loader_t(SDL_Renderer *renderer, int threads = 2);
+    ~asset_loader_t();
+
+    asset_loader_t(const asset_loader_t &) = delete;
+    asset_loader_t &operator=(const asset_loader_t &) = delete;
+
+    texture_handle_t load_image(const char *path, bool color_key = false);
+    texture_handle_t load_atlas(const std::vector<atlas_image_t> &images);
+
+    // Ponownie wczytuje w tle plik path we wszystkich teksturach, które go
+    // zawierają; pozostałe pliki nie są dekodowane. Nowy obraz atlasu o tym
+    // samym rozmiarze trafia w miejsce starego w istniejącej teksturze,
+    // pojedynczy obraz dostaje nową teksturę podmienianą w uchwycie - w obu
+    // przypadkach między klatkami, w process_uploads(). Obraz atlasu o innym
+    // rozmiarze wymaga ułożenia atlasu od nowa (wczytania wszystkich plików).
+    // Zwraca liczbę tekstur, które zostaną odświeżone.
+    int reload(const std::string &path);
+
+    // Przesyła gotowe obrazy do tekstur przez najwyżej budget_ms milisekund
+    // (zawsze co najmniej jeden pas); zwraca liczbę ukończonych tekstur
+    int process_uploads(double budget_ms);
+
+    // Czeka, aż wszystkie zlecone obrazy będą gotowe (np. ekran wczytywania)
+    void finish();
+
+    int pending() const { return pending_count; }
+
+private:
+    struct job_t {
+        texture_handle_t target;
+        std::vector<std::string> paths;
+        std::vector<char> color_keys;
+        bool atlas = false;
+        int patch_index = -1; // >= 0 - jeden obraz wstawiany w gotowy atlas
+
+        // Wynik wątku roboczego
+        SDL_Surface *surface = nullptr;
+        std::vector<SDL_Rect> rects;
+        bool failed = false;
+
+        // Stan przesyłania w wątku gry
+        SDL_Texture *texture = nullptr;
+        int rows_uploaded = 0;
+        job_t *next = nullptr;
+    };
+
+    texture_handle_t submit(job_t *job);
+    void enqueue(job_t *job);
+    job_t *atlas_job(const texture_handle_t &target);
+    bool patch_atlas(job_t *job);
+    void worker_loop();
+    void decode(job_t *job);
+    bool upload_step(job_t *job);
+    void free_job(job_t *job);
+
+    SDL_Renderer *renderer;
+    std::shared_ptr<SDL_Texture> placeholder;
+    int max_size;
+    int pending_count = 0;
+    std::vector<std::weak_ptr<async_texture_t>> textures; // wszystkie wydane uchwyty (do reload)
+
+    // Zlecenia dla wątków roboczych
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<job_t *> requests;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    // Gotowe powierzchnie: stos Treibera, wątki robocze dokładają, wątek gry
+    // zabiera wszystko naraz (exchange), więc nie ma problemu ABA
+    std::atomic<job_t *> decoded{nullptr};
+
+    // Kolejka przesyłania (tylko wątek gry), w kolejności zleceń
+    job_t *upload_head = nullptr;
+    job_t *upload_tail = nullptr;
+};
+
+#endif
@@ -0,0 +1,203 @@
+#include "audio_mixer.h"
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define AUDIO_MIXER_SSE 1
+#endif
+
+void mix_add(float *out, const float *in, int count, float gain) {
+    int i = 0;
+#ifdef AUDIO_MIXER_SSE
+    const __m128 g = _mm_set1_ps(gain);
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(in + i), g));
+        __m128 b = _mm_add_ps(_mm_loadu_ps(out + i + 4), _mm_mul_ps(_mm_loadu_ps(in + i + 4), g));
+        _mm_storeu_ps(out + i, a);
+        _mm_storeu_ps(out + i + 4, b);
+    }
+#endif
+    for (; i < count; i++) out[i] += in[i] * gain;
+}
+
+// Obcina sumę głosów do -1..1 (float32 poza tym zakresem urządzenie przesterowałoby)
+static void clamp_samples(float *out, int count) {
+    int i = 0;
+#ifdef AUDIO_MIXER_SSE
+    const __m128 lo = _mm_set1_ps(-1.0f), hi = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4) _mm_storeu_ps(out + i, _mm_min_ps(hi, _mm_max_ps(lo, _mm_loadu_ps(out + i))));
+#endif
+    for (; i < count; i++) out[i] = out[i] < -1.0f ? -1.0f : out[i] > 1.0f ? 1.0f : out[i];
+}
+
+audio_mixer_t::audio_mixer_t(const std::vector<std::string> &sound_paths, int frequency, int samples)
+        : sounds(new sound_t[sound_paths.size()]), sound_count((int) sound_paths.size()) {
+    if (!SDL_WasInit(SDL_INIT_AUDIO)) {
+        if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_AUDIO, "Couldn't initialize audio: %s", SDL_GetError());
+            throw std::runtime_error(SDL_GetError());
+        }
+        audio_initialized = true;
+    }
+
+    SDL_AudioSpec want;
+    SDL_zero(want);
+    want.freq = frequency;
+    want.format = AUDIO_F32SYS;
+    want.channels = 2;
+    want.samples = (Uint16) samples;
+    want.callback = audio_callback;
+    want.userdata = this;
+    // Format zostaje float32 (SDL przekształci go dla urządzenia), reszta jak chce urządzenie
+    device = SDL_OpenAudioDevice(NULL, 0, &want, &spec,
+                                 SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_CHANNELS_CHANGE |
+                                 SDL_AUDIO_ALLOW_SAMPLES_CHANGE);
+    if (!device) {
+        SDL_LogError(SDL_LOG_CATEGORY_AUDIO, "Couldn't open audio device: %s", SDL_GetError());
+        std::string error = SDL_GetError();
+        if (audio_initialized) SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        throw std::runtime_error(error);
+    }
+
+    loader = std::thread(&audio_mixer_t::load_loop, this, sound_paths);
+    SDL_PauseAudioDevice(device, 0);
+}
+
+audio_mixer_t::~audio_mixer_t() {
+    stopping.store(true, std::memory_order_relaxed);
+    // Zamknięcie czeka na koniec bieżącego wywołania zwrotnego
+    SDL_CloseAudioDevice(device);
+    if (loader.joinable()) loader.join();
+    if (audio_initialized) SDL_QuitSubSystem(SDL_INIT_AUDIO);
+}
+
+bool audio_mixer_t::load_sound(const std::string &path, sound_t &sound) {
+    SDL_AudioSpec wav_spec;
+    Uint8 *buffer = nullptr;
+    Uint32 length = 0;
+    if (!SDL_LoadWAV(path.c_str(), &wav_spec, &buffer, &length)) {
+        SDL_LogError(SDL_LOG_CATEGORY_AUDIO, "Couldn't load sound %s: %s", path.c_str(), SDL_GetError());
+        return false;
+    }
+    SDL_AudioStream *stream = SDL_NewAudioStream(wav_spec.format, wav_spec.channels, wav_spec.freq,
+                                                 AUDIO_F32SYS, spec.channels, spec.freq);
+    bool ok = stream && SDL_AudioStreamPut(stream, buffer, (int) length) == 0 && SDL_AudioStreamFlush(stream) == 0;
+    if (ok) {
+        int available = SDL_AudioStreamAvailable(stream);
+        sound.samples.resize((size_t) available / sizeof(float));
+        ok = SDL_AudioStreamGet(stream, sound.samples.data(), available) == available;
+        sound.frames = (int) (sound.samples.size() / spec.channels);
+    }
+    if (!ok) SDL_LogError(SDL_LOG_CATEGORY_AUDIO, "Couldn't convert sound %s: %s", path.c_str(), SDL_GetError());
+    if (stream) SDL_FreeAudioStream(stream);
+    SDL_FreeWAV(buffer);
+    return ok;
+}
+
+void audio_mixer_t::load_loop(std::vector<std::string> paths) {
+    for (int i = 0; i < sound_count && !stopping.load(std::memory_order_relaxed); i++) {
+        if (load_sound(paths[i], sounds[i])) sounds[i].ready.store(true, std::memory_order_release);
+    }
+    sounds_loaded.store(true, std::memory_order_release);
+}
+
+bool audio_mixer_t::sound_ready(int sound) const {
+    return sound >= 0 && sound < sound_count && sounds[sound].ready.load(std::memory_order_acquire);
+}
+
+bool audio_mixer_t::push(const command_t &command) {
+    unsigned h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= AUDIO_MIXER_COMMANDS) {
+        dropped_commands.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    commands[h & (AUDIO_MIXER_COMMANDS - 1)] = command;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+bool audio_mixer_t::play(int sound, float volume) {
+    if (!sound_ready(sound)) return false;
+    return push({COMMAND_PLAY, sound, volume});
+}
+
+bool audio_mixer_t::stop_all() {
+    return push({COMMAND_STOP_ALL, -1, 0});
+}
+
+void audio_mixer_t::apply_commands() {
+    unsigned t = tail.load(std::memory_order_relaxed);
+    unsigned h = head.load(std::memory_order_acquire);
+    for (; t != h; t++) {
+        const command_t &command = commands[t & (AUDIO_MIXER_COMMANDS - 1)];
+        if (command.type == COMMAND_STOP_ALL) {
+            for (voice_t &voice : voices) voice.sound = -1;
+            active_voices = 0;
+            continue;
+        }
+        // Wolny głos, a gdy wszystkie grają - ten, który gra najdłużej
+        voice_t *target = nullptr;
+        for (voice_t &voice : voices) {
+            if (voice.sound < 0) {
+                target = &voice;
+                break;
+            }
+            if (!target || voice.position > target->position) target = &voice;
+        }
+        if (target->sound >= 0) {
+            stolen_voices.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            active_voices++;
+        }
+        target->sound = command.sound;
+        target->position = 0;
+        target->volume = command.volume;
+    }
+    tail.store(t, std::memory_order_release);
+}
+
+void audio_mixer_t::mix(float *out, int frames) {
+    using namespace std::chrono;
+    steady_clock::time_point start = steady_clock::now();
+
+    const int channels = spec.channels;
+    std::memset(out, 0, sizeof(float) * frames * channels);
+    apply_commands();
+    if (active_voices > peak_voices.load(std::memory_order_relaxed)) {
+        peak_voices.store(active_voices, std::memory_order_relaxed);
+    }
+    if (active_voices > 0) {
+        for (voice_t &voice : voices) {
+            if (voice.sound < 0) continue;
+            const sound_t &sound = sounds[voice.sound];
+            int n = sound.frames - voice.position;
+            if (n > frames) n = frames;
+            mix_add(out, sound.samples.data() + (size_t) voice.position * channels, n * channels, voice.volume);
+            voice.position += n;
+            if (voice.position >= sound.frames) {
+                voice.sound = -1;
+                active_voices--;
+            }
+        }
+        clamp_samples(out, frames * channels);
+    }
+
+    long long ns = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+    callbacks.fetch_add(1, std::memory_order_relaxed);
+    mixed_frames.fetch_add(frames, std::memory_order_relaxed);
+    callback_ns.fetch_add(ns, std::memory_order_relaxed);
+    if (ns > max_callback_ns.load(std::memory_order_relaxed)) max_callback_ns.store(ns, std::memory_order_relaxed);
+}
+
+void SDLCALL audio_mixer_t::audio_callback(void *userdata, Uint8 *stream, int length) {
+    audio_mixer_t *mixer = (audio_mixer_t *) userdata;
+    mixer->mix((float *) stream, length / (int) (sizeof(float) * mixer->spec.channels));
+}
+
+void audio_mixer_t::mix_locked(float *out, int frames) {
+    SDL_LockAudioDevice(device);
+    mix(out, frames);
+    SDL_UnlockAudioDevice(device);
+}
@@ -0,0 +1,120 @@
+#ifndef MYGAME_AUDIO_MIXER_H
+#define MYGAME_AUDIO_MIXER_H
+
+#include "SDL2/SDL.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Najwięcej dźwięków grających naraz; nowy dźwięk ponad limit zastępuje
+// najdłużej grający
+#define AUDIO_MIXER_VOICES 64
+
+// Pojemność kolejki poleceń wątek gry -> wywołanie zwrotne (potęga dwójki)
+#define AUDIO_MIXER_COMMANDS 256
+
+// out[i] += in[i] * gain dla count próbek (SSE, gdy jest dostępne)
+void mix_add(float *out, const float *in, int count, float gain);
+
+// Mikser efektów dźwiękowych. Pliki WAV są wczytywane (SDL_LoadWAV)
+// i przekształcane SDL_AudioStream do formatu urządzenia (float32, jego
+// częstotliwość i liczba kanałów) raz, w wątku ładującym miksera, więc
+// wywołanie zwrotne tylko sumuje gotowe próbki. Wątek gry zleca dźwięki przez
+// play() - polecenie trafia do bezblokadowej kolejki jednego pisarza i jednego
+// czytelnika (wywołania zwrotnego), więc ani wątek gry nie czeka na dźwięk,
+// ani dźwięk na wątek gry. Sterownik wybiera SDL (SDL_AUDIODRIVER); z "dummy"
+// albo "disk" mikser działa bez karty dźwiękowej.
+class audio_mixer_t {
+public:
+    // Otwiera urządzenie i zaczyna wczytywać sound_paths w tle; dźwięk numer i
+    // to plik sound_paths[i]. Rzuca std::runtime_error, gdy nie ma urządzenia.
+    explicit audio_mixer_t(const std::vector<std::string> &sound_paths, int frequency = 48000, int samples = 512);
+    ~audio_mixer_t();
+
+    audio_mixer_t(const audio_mixer_t &) = delete;
+    audio_mixer_t &operator=(const audio_mixer_t &) = delete;
+
+    // Wątek gry (jeden): zleca odtworzenie dźwięku z głośnością volume;
+    // false, gdy kolejka jest pełna. Dźwięk, który jeszcze się nie wczytał
+    // albo nie dał się wczytać, jest pomijany.
+    bool play(int sound, float volume = 1.0f);
+
+    // Wątek gry: zatrzymuje wszystkie dźwięki
+    bool stop_all();
+
+    // Czy wątek ładujący skończył (z błędami lub bez)
+    bool loaded() const { return sounds_loaded.load(std::memory_order_acquire); }
+    void wait_loaded() { if (loader.joinable()) loader.join(); }
+
+    bool sound_ready(int sound) const;
+
+    const SDL_AudioSpec &device_spec() const { return spec; }
+
+    // Wstrzymuje wywołania zwrotne urządzenia (np. na czas mix_locked w pomiarach)
+    void set_paused(bool paused) { SDL_PauseAudioDevice(device, paused ? 1 : 0); }
+
+    // Miesza frames ramek do out (float32 w formacie urządzenia) z
+    // zablokowanym urządzeniem - tak jak wywołanie zwrotne; do pomiarów
+    void mix_locked(float *out, int frames);
+
+    // Statystyki wywołania zwrotnego (czytane z dowolnego wątku)
+    std::atomic<long long> callbacks{0};
+    std::atomic<long long> mixed_frames{0};
+    std::atomic<long long> callback_ns{0};     // łączny czas mieszania
+    std::atomic<long long> max_callback_ns{0};
+    std::atomic<int> peak_voices{0};
+    std::atomic<long long> stolen_voices{0};   // dźwięki przerwane przez nowe ponad limit
+    std::atomic<long long> dropped_commands{0}; // pełna kolejka
+
+private:
+    enum command_type_t { COMMAND_PLAY, COMMAND_STOP_ALL };
+
+    struct command_t {
+        command_type_t type;
+        int sound;
+        float volume;
+    };
+
+    // Dźwięk przekształcony do formatu urządzenia (ramki po spec.channels próbek)
+    struct sound_t {
+        std::vector<float> samples;
+        int frames = 0;
+        std::atomic<bool> ready{false};
+    };
+
+    struct voice_t {
+        int sound = -1; // -1 - wolny głos
+        int position = 0; // następna ramka
+        float volume = 1.0f;
+    };
+
+    static void SDLCALL audio_callback(void *userdata, Uint8 *stream, int length);
+    bool push(const command_t &command);
+    void apply_commands();
+    void mix(float *out, int frames);
+    void load_loop(std::vector<std::string> paths);
+    bool load_sound(const std::string &path, sound_t &sound);
+
+    SDL_AudioDeviceID device = 0;
+    SDL_AudioSpec spec;
+    bool audio_initialized = false; // podsystem audio zainicjowany przez mikser
+
+    std::unique_ptr<sound_t[]> sounds;
+    int sound_count = 0;
+    std::thread loader;
+    std::atomic<bool> sounds_loaded{false};
+    std::atomic<bool> stopping{false};
+
+    // Kolejka poleceń: head przesuwa wątek gry, tail wywołanie zwrotne
+    command_t commands[AUDIO_MIXER_COMMANDS];
+    std::atomic<unsigned> head{0};
+    std::atomic<unsigned> tail{0};
+
+    // Stan wywołania zwrotnego
+    voice_t voices[AUDIO_MIXER_VOICES];
+    int active_voices = 0;
+};
+
+#endif
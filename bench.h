@@ -0,0 +1,141 @@
+#ifndef MYGAME_BENCH_H
+#define MYGAME_BENCH_H
+
+// Wspólna część programów bench_*: rozgrzewka, powtórzenia, statystyki
+// (średnia, odchylenie standardowe, percentyle) i zapis wyników do JSON.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct bench_options_t {
+    int warmup = 5;                 // powtórzenia niemierzone
+    int repetitions = 30;           // powtórzenia mierzone
+    const char *json_path = nullptr; // "-" - JSON na standardowe wyjście
+    const char *filter = nullptr;   // tylko pomiary, których nazwa zawiera ten tekst
+};
+
+// Wynik jednego pomiaru; czasy w milisekundach na powtórzenie
+struct bench_result_t {
+    std::string name;
+    double items = 1; // jednostki pracy w jednym powtórzeniu (kroki, klatki, obrazy)
+    int repetitions = 0;
+    double mean = 0, stddev = 0, min = 0, p50 = 0, p90 = 0, p99 = 0, max = 0;
+
+    double ns_per_item() const { return mean * 1e6 / items; }
+};
+
+// Wspólne opcje --warmup, --repetitions, --json, --filter: jeśli argv[i] jest
+// jedną z nich, odczytuje ją (przesuwając i za wartość) i zwraca true
+inline bool parse_bench_option(int argc, char *argv[], int &i, bench_options_t &options) {
+    if (i + 1 >= argc) return false;
+    if (!std::strcmp(argv[i], "--warmup")) options.warmup = std::max(0, std::atoi(argv[++i]));
+    else if (!std::strcmp(argv[i], "--repetitions")) options.repetitions = std::max(1, std::atoi(argv[++i]));
+    else if (!std::strcmp(argv[i], "--json")) options.json_path = argv[++i];
+    else if (!std::strcmp(argv[i], "--filter")) options.filter = argv[++i];
+    else return false;
+    return true;
+}
+
+inline const char *bench_options_usage() {
+    return "[--warmup N] [--repetitions N] [--json PATH|-] [--filter TEXT]";
+}
+
+// Percentyl metodą najbliższej rangi z posortowanych próbek
+inline double bench_percentile(const std::vector<double> &sorted, double p) {
+    size_t rank = (size_t) std::ceil(p / 100.0 * (double) sorted.size());
+    if (rank < 1) rank = 1;
+    if (rank > sorted.size()) rank = sorted.size();
+    return sorted[rank - 1];
+}
+
+// Wykonuje fn() options.warmup razy bez pomiaru, potem options.repetitions
+// razy, mierząc każde wywołanie osobno. Przed każdym wywołaniem fn() (także
+// w rozgrzewce) wywołuje setup() poza pomiarem - np. przywrócenie stanu
+// początkowego. Wynik trafia do results i na ekran.
+template<class setup_t, class fn_t>
+void run_bench(std::vector<bench_result_t> &results, const bench_options_t &options, const std::string &name,
+               double items, setup_t setup, fn_t fn) {
+    using namespace std::chrono;
+    if (options.filter && name.find(options.filter) == std::string::npos) return;
+
+    for (int i = 0; i < options.warmup; i++) {
+        setup();
+        fn();
+    }
+    std::vector<double> samples((size_t) options.repetitions);
+    for (double &sample : samples) {
+        setup();
+        steady_clock::time_point start = steady_clock::now();
+        fn();
+        sample = duration<double, std::milli>(steady_clock::now() - start).count();
+    }
+    std::sort(samples.begin(), samples.end());
+
+    bench_result_t result;
+    result.name = name;
+    result.items = items;
+    result.repetitions = options.repetitions;
+    double sum = 0;
+    for (double sample : samples) sum += sample;
+    result.mean = sum / (double) samples.size();
+    double variance = 0;
+    for (double sample : samples) variance += (sample - result.mean) * (sample - result.mean);
+    result.stddev = samples.size() > 1 ? std::sqrt(variance / (double) (samples.size() - 1)) : 0.0;
+    result.min = samples.front();
+    result.p50 = bench_percentile(samples, 50);
+    result.p90 = bench_percentile(samples, 90);
+    result.p99 = bench_percentile(samples, 99);
+    result.max = samples.back();
+
+    std::printf("%-36s mean=%.4fms stddev=%.4fms p50=%.4fms p99=%.4fms max=%.4fms ns_per_item=%.1f\n",
+                name.c_str(), result.mean, result.stddev, result.p50, result.p99, result.max, result.ns_per_item());
+    results.push_back(result);
+}
+
+template<class fn_t>
+void run_bench(std::vector<bench_result_t> &results, const bench_options_t &options, const std::string &name,
+               double items, fn_t fn) {
+    run_bench(results, options, name, items, [] {}, fn);
+}
+
+// Zmusza kompilator do policzenia value (np. wyniku, który pomiar tylko
+// liczy), bez kosztu w mierzonej pętli
+template<class T>
+inline void bench_do_not_optimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static const volatile void *sink;
+    sink = &value;
+#endif
+}
+
+// Zapisuje wyniki jako JSON: {"benchmark": ..., "results": [{...}, ...]}
+inline bool write_bench_json(const char *path, const char *benchmark, const bench_options_t &options,
+                             const std::vector<bench_result_t> &results) {
+    FILE *file = std::strcmp(path, "-") ? std::fopen(path, "w") : stdout;
+    if (!file) {
+        std::fprintf(stderr, "Couldn't write %s\n", path);
+        return false;
+    }
+    std::fprintf(file, "{\n  \"benchmark\": \"%s\",\n  \"warmup\": %d,\n  \"results\": [", benchmark, options.warmup);
+    for (size_t i = 0; i < results.size(); i++) {
+        const bench_result_t &r = results[i];
+        std::fprintf(file,
+                     "%s\n    {\"name\": \"%s\", \"repetitions\": %d, \"items_per_repetition\": %.0f, "
+                     "\"mean_ms\": %.6f, \"stddev_ms\": %.6f, \"min_ms\": %.6f, \"p50_ms\": %.6f, "
+                     "\"p90_ms\": %.6f, \"p99_ms\": %.6f, \"max_ms\": %.6f, \"ns_per_item\": %.3f}",
+                     i ? "," : "", r.name.c_str(), r.repetitions, r.items, r.mean, r.stddev, r.min, r.p50, r.p90,
+                     r.p99, r.max, r.ns_per_item());
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+    if (file != stdout) return std::fclose(file) == 0;
+    return true;
+}
+
+#endif
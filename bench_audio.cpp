@@ -0,0 +1,103 @@
+// Benchmark miksera dźwięku (audio_mixer_t) bez karty dźwiękowej: SDL
+// z wybranym sterownikiem "dummy" albo "disk" (zapis do pliku, zob.
+// SDL_DISKAUDIOFILE). Mierzy mieszanie bloków przy 1, 8 i 64 głosach
+// (mix_locked z wstrzymanym urządzeniem), samo mix_add, a potem wywołania
+// zwrotne urządzenia, gdy główny wątek co 1/60 s zleca nowe dźwięki.
+#include "audio_mixer.h"
+#include "bench.h"
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#ifndef MYGAME_SOUND_DIR
+#define MYGAME_SOUND_DIR "Sound"
+#endif
+
+int main(int argc, char *argv[]) {
+    using namespace std::chrono;
+    bench_options_t options;
+    options.warmup = 2;
+    options.repetitions = 20;
+    std::string dir = MYGAME_SOUND_DIR;
+    const char *driver = "dummy";
+    double live_seconds = 2.0;
+    for (int i = 1; i < argc; i++) {
+        if (parse_bench_option(argc, argv, i, options)) continue;
+        if (!std::strcmp(argv[i], "--sounds") && i + 1 < argc) dir = argv[++i];
+        else if (!std::strcmp(argv[i], "--driver") && i + 1 < argc) driver = argv[++i];
+        else if (!std::strcmp(argv[i], "--seconds") && i + 1 < argc) live_seconds = std::atof(argv[++i]);
+        else {
+            std::printf("usage: %s [--sounds DIR] [--driver dummy|disk] [--seconds N] %s\n", argv[0],
+                        bench_options_usage());
+            return 2;
+        }
+    }
+    SDL_setenv("SDL_AUDIODRIVER", driver, 1);
+
+    std::vector<std::string> paths = {dir + "/jump.wav", dir + "/land.wav", dir + "/level.wav"};
+    std::unique_ptr<audio_mixer_t> mixer;
+    try {
+        mixer.reset(new audio_mixer_t(paths));
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "Couldn't open audio driver %s: %s\n", driver, e.what());
+        return 3;
+    }
+    mixer->wait_loaded();
+    for (int i = 0; i < (int) paths.size(); i++) {
+        if (!mixer->sound_ready(i)) {
+            std::fprintf(stderr, "Couldn't load %s (run from the source directory or pass --sounds)\n",
+                         paths[i].c_str());
+            return 3;
+        }
+    }
+    const SDL_AudioSpec &spec = mixer->device_spec();
+    std::printf("driver=%s frequency=%d channels=%d block=%d frames\n", SDL_GetCurrentAudioDriver(), spec.freq,
+                spec.channels, spec.samples);
+
+    std::vector<bench_result_t> results;
+
+    // Mieszanie z wstrzymanym urządzeniem: voices razy level.wav (najdłuższy),
+    // 32 bloki - wszystkie głosy grają do końca pomiaru
+    mixer->set_paused(true);
+    const int block = spec.samples, blocks = 32;
+    std::vector<float> out((size_t) block * spec.channels);
+    for (int voices : {1, 8, AUDIO_MIXER_VOICES}) {
+        run_bench(results, options, "mix/voices=" + std::to_string(voices), (double) block * blocks, [&] {
+            mixer->stop_all();
+            for (int v = 0; v < voices; v++) mixer->play(2, 0.5f);
+            for (int b = 0; b < blocks; b++) mixer->mix_locked(out.data(), block);
+        });
+    }
+
+    // Samo sumowanie: jeden głos przez blok 64 * 1024 próbek
+    std::vector<float> source(64 * 1024, 0.25f), target(64 * 1024, 0.0f);
+    run_bench(results, options, "mix_add/64k_samples", (double) source.size(), [&] {
+        mix_add(target.data(), source.data(), (int) source.size(), 0.5f);
+    });
+
+    // Urządzenie w działaniu: wątek gry zleca 8 dźwięków na krok 60 Hz, więc
+    // limit głosów jest stale przekraczany
+    long long callbacks_before = mixer->callbacks.load(), ns_before = mixer->callback_ns.load();
+    mixer->max_callback_ns.store(0);
+    mixer->set_paused(false);
+    steady_clock::time_point start = steady_clock::now();
+    long long requests = 0;
+    for (int tick = 0; duration<double>(steady_clock::now() - start).count() < live_seconds; tick++) {
+        for (int i = 0; i < 8; i++, requests++) mixer->play((tick + i) % (int) paths.size(), 0.3f);
+        std::this_thread::sleep_until(start + duration_cast<steady_clock::duration>(duration<double>((tick + 1) / 60.0)));
+    }
+    long long callbacks = mixer->callbacks.load() - callbacks_before;
+    double mean_us = callbacks ? (mixer->callback_ns.load() - ns_before) / 1e3 / callbacks : 0;
+    double period_us = 1e6 * spec.samples / spec.freq;
+    std::printf("live seconds=%.1f requests=%lld callbacks=%lld mean_callback_us=%.2f max_callback_us=%.2f "
+                "period_us=%.0f load=%.3f%% peak_voices=%d stolen=%lld dropped=%lld\n",
+                live_seconds, requests, callbacks, mean_us, mixer->max_callback_ns.load() / 1e3, period_us,
+                100.0 * mean_us / period_us, mixer->peak_voices.load(), mixer->stolen_voices.load(),
+                mixer->dropped_commands.load());
+
+    mixer.reset();
+    SDL_Quit();
+
+    if (options.json_path && !write_bench_json(options.json_path, "bench_audio", options, results)) return 1;
+    return 0;
+}
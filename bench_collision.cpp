@@ -0,0 +1,205 @@
+// Mikrobenchmark fizyki gracza: koszt jednego kroku update_player (ze
+// sweep_aabb) na jedną postać, osobno dla game_map_t, packed_map_t
+// i collision_rects_t, sweep_aabb szerokiego obiektu oraz promienie.
+// Zlicza też alokacje w mierzonej pętli - krok fizyki nie powinien alokować.
+#include "bench.h"
+#include "bench_fixtures.h"
+#include "collision_rects.h"
+#include "game.h"
+#include "level_generator.h"
+#include "packed_map.h"
+#include <atomic>
+#include <cmath>
+#include <new>
+#include <utility>
+
+static std::atomic<long long> allocations{0};
+
+void *operator new(size_t size) {
+    allocations++;
+    void *p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+template<class map_t>
+static void run_update_player(std::vector<bench_result_t> &results, const bench_options_t &options,
+                              const std::string &name, const map_t &map, int entity_count, int steps) {
+    const double dt = 1.0 / 60.0;
+    const std::vector<player_t> start = make_bench_players(entity_count, map.width);
+    std::vector<player_t> entities = start;
+    long long allocated = 0;
+    run_bench(results, options, "update_player/" + name, (double) entity_count * steps, [&] {
+        entities = start;
+        long long allocations_before = allocations.load();
+        for (int s = 0; s < steps; s++) {
+            for (player_t &e : entities) {
+                // Skok co sekundę, żeby postacie nie tylko leżały na ziemi
+                if (s % 60 == 0 && is_on_the_ground(e, map)) e.a.v.y = -500;
+                if (s % 60 == 5) e.a.v.y = 0;
+                e = update_player(e, map, dt);
+            }
+        }
+        allocated += allocations.load() - allocations_before;
+    });
+
+    double checksum = 0;
+    for (const player_t &e : entities) checksum += e.p.v.x + e.p.v.y;
+    std::printf("  allocations=%lld checksum=%.3f\n", allocated, checksum);
+}
+
+struct wide_sweep_t {
+    double x, y, dx, dy;
+};
+
+// Przesunięcia szerokiego obiektu (8x2 kafelki) w losowych kierunkach,
+// losowane przed pomiarem, żeby wszystkie typy map dostały te same
+static std::vector<wide_sweep_t> make_wide_sweeps(int width, int height, const aabb_t &box, int count) {
+    unsigned seed = 777;
+    auto random_unit = [&] { return (double) ((bench_random(seed) >> 8) % 10000) / 10000.0; };
+    std::vector<wide_sweep_t> sweeps((size_t) count);
+    for (wide_sweep_t &s : sweeps) {
+        s.x = box.half_width + random_unit() * (width - 2 * box.half_width);
+        s.y = box.height + random_unit() * (height - box.height);
+        s.dx = (random_unit() - 0.5) * 8;
+        s.dy = (random_unit() - 0.5) * 8;
+    }
+    return sweeps;
+}
+
+// Tu liczy się koszt solid_in_span/solid_in_column na długich odcinkach
+template<class map_t>
+static void run_wide_sweep(std::vector<bench_result_t> &results, const bench_options_t &options,
+                           const std::string &name, const map_t &map, const aabb_t &box,
+                           const std::vector<wide_sweep_t> &sweeps) {
+    long long allocated = 0;
+    double checksum = 0;
+    run_bench(results, options, "wide_sweep/" + name, (double) sweeps.size(), [&] {
+        long long allocations_before = allocations.load();
+        checksum = 0;
+        for (const wide_sweep_t &s : sweeps) {
+            sweep_result_t result = sweep_aabb(map, box, s.x, s.y, s.dx, s.dy);
+            checksum += result.x + result.y + result.normal_x + result.normal_y;
+        }
+        bench_do_not_optimize(checksum);
+        allocated += allocations.load() - allocations_before;
+    });
+    std::printf("  allocations=%lld checksum=%.3f\n", allocated, checksum);
+}
+
+// Promień kafelek po kafelku (Amanatides-Woo) - punkt odniesienia dla
+// collision_rects_t::raycast; odległość do pierwszego pełnego kafelka albo -1
+static double tile_raycast(const packed_map_t &map, double x, double y, double dx, double dy, double max_distance) {
+    int tx = floor_to_int(x), ty = floor_to_int(y);
+    const int step_x = dx > 0 ? 1 : -1, step_y = dy > 0 ? 1 : -1;
+    double next_x = dx != 0 ? ((tx + (dx > 0)) - x) / dx : INFINITY;
+    double next_y = dy != 0 ? ((ty + (dy > 0)) - y) / dy : INFINITY;
+    const double delta_x = dx != 0 ? 1 / std::fabs(dx) : INFINITY;
+    const double delta_y = dy != 0 ? 1 / std::fabs(dy) : INFINITY;
+    double t = 0;
+    while (t <= max_distance && tx >= 0 && tx < map.width && ty >= 0 && ty < map.height) {
+        if (map.get(tx, ty) > 0) return t;
+        if (next_x < next_y) {
+            t = next_x;
+            tx += step_x;
+            next_x += delta_x;
+        } else {
+            t = next_y;
+            ty += step_y;
+            next_y += delta_y;
+        }
+    }
+    return -1;
+}
+
+// Promienie z losowych pustych pól w losowych kierunkach (jak linia wzroku);
+// sumy kontrolne obu metod muszą się zgadzać
+static void run_raycasts(std::vector<bench_result_t> &results, const bench_options_t &options,
+                         const std::string &name, const packed_map_t &packed, const collision_rects_t &rects,
+                         int rays) {
+    const double max_distance = 64;
+    struct ray_t {
+        double x, y, dx, dy;
+    };
+    std::vector<ray_t> batch;
+    unsigned seed = 4242;
+    auto random_unit = [&] { return (double) ((bench_random(seed) >> 8) % 10000) / 10000.0; };
+    while ((int) batch.size() < rays) {
+        double x = random_unit() * packed.width, y = random_unit() * packed.height;
+        if (packed.get(floor_to_int(x), floor_to_int(y)) > 0) continue;
+        double angle = random_unit() * 6.283185307179586;
+        batch.push_back({x, y, std::cos(angle), std::sin(angle)});
+    }
+
+    double tile_sum = 0, rect_sum = 0;
+    run_bench(results, options, "raycast/" + name + "/tiles", (double) rays, [&] {
+        tile_sum = 0;
+        for (const ray_t &r : batch) tile_sum += tile_raycast(packed, r.x, r.y, r.dx, r.dy, max_distance);
+        bench_do_not_optimize(tile_sum);
+    });
+    run_bench(results, options, "raycast/" + name + "/rects", (double) rays, [&] {
+        rect_sum = 0;
+        for (const ray_t &r : batch) {
+            ray_hit_t hit;
+            rect_sum += rects.raycast(r.x, r.y, r.dx, r.dy, max_distance, hit) ? hit.distance : -1;
+        }
+        bench_do_not_optimize(rect_sum);
+    });
+    std::printf("  checksum tiles=%.3f rects=%.3f\n", tile_sum, rect_sum);
+}
+
+int main(int argc, char *argv[]) {
+    bench_options_t options;
+    options.warmup = 1;
+    options.repetitions = 5;
+    int entity_count = 1000;
+    int steps = 2000;
+    for (int i = 1; i < argc; i++) {
+        if (parse_bench_option(argc, argv, i, options)) continue;
+        if (!std::strcmp(argv[i], "--entities") && i + 1 < argc) entity_count = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--steps") && i + 1 < argc) steps = std::atoi(argv[++i]);
+        else {
+            std::printf("usage: %s [--entities N] [--steps N] %s\n", argv[0], bench_options_usage());
+            return 2;
+        }
+    }
+
+    // game_map1 i duży wygenerowany poziom (długie podłogi, głębokie podłoże)
+    std::vector<bench_result_t> results;
+    std::unique_ptr<generated_level_t> large = generate_segment(1, 0, 256, 64);
+    const std::pair<const char *, const game_map_t *> maps[] = {{"game_map1", &game_map1},
+                                                                {"generated", &large->map}};
+    for (const std::pair<const char *, const game_map_t *> &entry : maps) {
+        const std::string map_name = entry.first;
+        const game_map_t &map = *entry.second;
+        packed_map_t packed(map);
+        collision_rects_t rects(map);
+        int solid_tiles = 0;
+        for (int v : map.map) solid_tiles += v > 0;
+        std::printf("%s %dx%d solid_tiles=%d rects=%zu rects_bytes=%zu\n", map_name.c_str(), map.width, map.height,
+                    solid_tiles, rects.rects().size(), rects.memory_bytes());
+
+        run_update_player(results, options, map_name + "/game_map_t", map, entity_count, steps);
+        run_update_player(results, options, map_name + "/packed_map_t", packed, entity_count, steps);
+        run_update_player(results, options, map_name + "/rects", rects, entity_count, steps);
+
+        const aabb_t box = {4, 2};
+        const std::vector<wide_sweep_t> sweeps = make_wide_sweeps(map.width, map.height, box, entity_count * 100);
+        run_wide_sweep(results, options, map_name + "/game_map_t", map, box, sweeps);
+        run_wide_sweep(results, options, map_name + "/packed_map_t", packed, box, sweeps);
+        run_wide_sweep(results, options, map_name + "/rects", rects, box, sweeps);
+
+        run_raycasts(results, options, map_name, packed, rects, entity_count * 100);
+    }
+
+    if (options.json_path && !write_bench_json(options.json_path, "bench_collision", options, results)) return 1;
+    return 0;
+}
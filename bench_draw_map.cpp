@@ -0,0 +1,137 @@
+// Benchmark rysowania mapy programowym rendererem SDL na powierzchni w
+// pamięci (bez okna, działa bez serwera grafiki): draw_map z osobnym
+// SDL_RenderCopy na kafelek i partia sprite_batch_t, a dla dużych map
+// (też chunked_map_t) rysowanie przez kamerę z obcinaniem do widoku. Jedno powtórzenie to stała liczba klatek.
+#include "bench.h"
+#include "bench_fixtures.h"
+#include "game.h"
+#include "render.h"
+
+// Tekstura kafelków jak block.bmp: kafelek n w kolumnie 128 * (n - 1),
+// generowana w pamięci, żeby wynik nie zależał od plików
+static SDL_Texture *make_tiles_texture(SDL_Renderer *renderer) {
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, 256, TILE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) return nullptr;
+    for (int tile = 0; tile < 2; tile++) {
+        for (int y = 0; y < TILE_SIZE; y += 8) {
+            for (int x = 0; x < TILE_SIZE; x += 8) {
+                SDL_Rect cell = {tile * 128 + x, y, 8, 8};
+                Uint8 shade = (Uint8) (((x ^ y) & 8) ? 0x80 : 0xc0);
+                SDL_FillRect(surface, &cell, SDL_MapRGB(surface->format, shade, (Uint8) (shade / 2 + tile * 60), 0x40));
+            }
+        }
+    }
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    return texture;
+}
+
+static void bench_map(std::vector<bench_result_t> &results, const bench_options_t &options, SDL_Renderer *renderer,
+                      SDL_Texture *tiles, const char *map_name, const game_map_t &map, int frames) {
+    auto frame = [&](auto draw) {
+        for (int f = 0; f < frames; f++) {
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0xff);
+            SDL_RenderClear(renderer);
+            draw();
+            SDL_RenderPresent(renderer); // programowy renderer wykonuje kolejkę poleceń tutaj
+        }
+    };
+
+    run_bench(results, options, std::string("draw_map/") + map_name, frames, [&] {
+        frame([&] { draw_map(renderer, map, tiles); });
+    });
+
+    int w, h;
+    SDL_QueryTexture(tiles, NULL, NULL, &w, &h);
+    const SDL_Rect tiles_rect = {0, 0, w, h};
+    sprite_batch_t batch;
+    run_bench(results, options, std::string("sprite_batch/") + map_name, frames, [&] {
+        frame([&] {
+            batch.begin(tiles);
+            batch_map(batch, map, tiles_rect);
+            batch.flush(renderer);
+        });
+    });
+}
+
+// Rysowanie przez kamerę ustawioną na środku mapy: koszt powinien zależeć od
+// rozmiaru widoku, a nie mapy
+template<class map_t>
+static void bench_camera(std::vector<bench_result_t> &results, const bench_options_t &options,
+                         SDL_Renderer *renderer, SDL_Texture *tiles, const char *map_name, const map_t &map,
+                         int frames) {
+    camera_t camera;
+    SDL_GetRendererOutputSize(renderer, &camera.width, &camera.height);
+    camera.follow(map.width / 2.0, map.height / 2.0, map.width, map.height);
+
+    run_bench(results, options, std::string("draw_map_camera/") + map_name, frames, [&] {
+        for (int f = 0; f < frames; f++) {
+            SDL_RenderClear(renderer);
+            draw_map(renderer, map, tiles, camera);
+            SDL_RenderPresent(renderer);
+        }
+    });
+
+    int w, h;
+    SDL_QueryTexture(tiles, NULL, NULL, &w, &h);
+    const SDL_Rect tiles_rect = {0, 0, w, h};
+    sprite_batch_t batch;
+    run_bench(results, options, std::string("sprite_batch_camera/") + map_name, frames, [&] {
+        for (int f = 0; f < frames; f++) {
+            SDL_RenderClear(renderer);
+            batch.begin(tiles);
+            batch_map(batch, map, tiles_rect, camera);
+            batch.flush(renderer);
+            SDL_RenderPresent(renderer);
+        }
+    });
+}
+
+int main(int argc, char *argv[]) {
+    bench_options_t options;
+    int frames = 10;
+    int width = 1280, height = 960;
+    for (int i = 1; i < argc; i++) {
+        if (parse_bench_option(argc, argv, i, options)) continue;
+        if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) frames = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--size") && i + 1 < argc &&
+                 std::sscanf(argv[++i], "%dx%d", &width, &height) == 2 && width > 0 && height > 0) {
+        } else {
+            std::printf("usage: %s [--frames N] [--size WIDTHxHEIGHT] %s\n", argv[0], bench_options_usage());
+            return 2;
+        }
+    }
+
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    SDL_Texture *tiles = renderer ? make_tiles_texture(renderer) : nullptr;
+    if (!tiles) {
+        std::fprintf(stderr, "Couldn't create software renderer: %s\n", SDL_GetError());
+        return 3;
+    }
+
+    // Mapy testowe: pełna podłoga, platformy co trzy wiersze, ok. 30% pełnych kafelków
+    auto test_map = [](int w, int h) { return make_bench_map(w, h, 3, 3, 70, 0); };
+    std::vector<bench_result_t> results;
+    bench_map(results, options, renderer, tiles, "game_map1_20x15", game_map1, frames);
+    bench_map(results, options, renderer, tiles, "generated_20x15", test_map(20, 15), frames);
+    bench_map(results, options, renderer, tiles, "generated_64x48", test_map(64, 48), frames);
+    bench_camera(results, options, renderer, tiles, "generated_64x48", test_map(64, 48), frames);
+    bench_camera(results, options, renderer, tiles, "generated_1024x256", test_map(1024, 256), frames);
+
+    // Świat 4096x4096 w chunkach; wczytane są tylko chunki wokół kamery
+    const game_map_t pattern = test_map(CHUNK_SIZE, CHUNK_SIZE);
+    chunked_map_t world(4096, 4096, [&](int, int, uint8_t *chunk) {
+        for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; i++) chunk[i] = (uint8_t) pattern.map[i];
+    });
+    world.stream_around(world.width / 2.0, world.height / 2.0);
+    bench_camera(results, options, renderer, tiles, "chunked_4096x4096", world, frames);
+
+    SDL_DestroyTexture(tiles);
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    SDL_Quit();
+
+    if (options.json_path && !write_bench_json(options.json_path, "bench_draw_map", options, results)) return 1;
+    return 0;
+}
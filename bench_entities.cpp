@@ -0,0 +1,98 @@
+// Benchmark magazynu obiektów SoA (entity_store_t): koszt kroku obiektu dla
+// 1k, 10k i 100k obiektów, w porównaniu z update_player na player_t
+// (soa/..., aos/...), oraz koszt fazy szerokiej (spatial_hash_t) na obiekt
+// i krok (broadphase/...).
+#include "bench.h"
+#include "bench_fixtures.h"
+#include "entities.h"
+#include "game.h"
+#include "packed_map.h"
+#include "spatial_hash.h"
+
+static void fill_store(entity_store_t &store, const packed_map_t &map, int count) {
+    store.reserve(count);
+    for (const player_t &p : make_bench_players(count, map.width, map.height - 4, 1)) {
+        store.add((float) p.p.v.x, (float) p.p.v.y, (float) p.v.v.x, 0, (float) p.a.v.x, 0);
+    }
+}
+
+static void run_soa(std::vector<bench_result_t> &results, const bench_options_t &options, const packed_map_t &map,
+                    int count, int steps) {
+    entity_store_t store;
+    fill_store(store, map, count);
+    const float dt = 1.0f / 60.0f;
+    run_bench(results, options, "soa/entities=" + std::to_string(count), (double) count * steps, [&] {
+        for (int s = 0; s < steps; s++) step_entities(store, map, dt);
+    });
+}
+
+static void run_aos(std::vector<bench_result_t> &results, const bench_options_t &options, const packed_map_t &map,
+                    int count, int steps) {
+    std::vector<player_t> players = make_bench_players(count, map.width, map.height - 4, 1);
+    const double dt = 1.0 / 60.0;
+    run_bench(results, options, "aos/entities=" + std::to_string(count), (double) count * steps, [&] {
+        for (int s = 0; s < steps; s++) {
+            for (player_t &p : players) p = update_player(p, map, dt);
+        }
+    });
+}
+
+// Mierzone jest tylko update() siatki i przejście po wszystkich parach;
+// krok fizyki przed każdym pomiarem przesuwa obiekty poza pomiarem
+static void run_broadphase(std::vector<bench_result_t> &results, const bench_options_t &options,
+                           const packed_map_t &map, int count) {
+    entity_store_t store;
+    fill_store(store, map, count);
+    spatial_hash_t grid;
+    const float dt = 1.0f / 60.0f;
+    for (int s = 0; s < 30; s++) {
+        step_entities(store, map, dt);
+        grid.update(store);
+    }
+
+    long long found = 0, passes = 0;
+    run_bench(results, options, "broadphase/entities=" + std::to_string(count), (double) count,
+              [&] { step_entities(store, map, dt); },
+              [&] {
+                  grid.update(store);
+                  grid.for_each_pair(store, [&](int, int) { found++; });
+                  passes++;
+              });
+    if (passes > 0) std::printf("  pairs_per_step=%.0f\n", (double) found / passes);
+}
+
+int main(int argc, char *argv[]) {
+    bench_options_t options;
+    options.warmup = 1;
+    options.repetitions = 5;
+    long long total = 2000000; // liczba kroków obiektów na jedno powtórzenie
+    for (int i = 1; i < argc; i++) {
+        if (parse_bench_option(argc, argv, i, options)) continue;
+        if (!std::strcmp(argv[i], "--total") && i + 1 < argc) total = std::atoll(argv[++i]);
+        else {
+            std::printf("usage: %s [--total ENTITY_STEPS] %s\n", argv[0], bench_options_usage());
+            return 2;
+        }
+    }
+    if (total < 1) {
+        std::printf("usage: %s [--total ENTITY_STEPS] %s\n", argv[0], bench_options_usage());
+        return 2;
+    }
+
+    // Szeroki poziom: podłoga z dziurami, rzadkie platformy co cztery wiersze
+    std::vector<bench_result_t> results;
+    packed_map_t map(make_bench_map(2048, 64, 7, 4, 17, 12));
+    const int counts[] = {1000, 10000, 100000};
+    for (int count : counts) {
+        int steps = (int) std::max(1LL, total / count);
+        size_t first = results.size();
+        run_soa(results, options, map, count, steps);
+        run_aos(results, options, map, count, steps);
+        // Oba pomiary mają tyle samo kroków, więc wystarczy stosunek czasów
+        if (results.size() == first + 2) std::printf("  speedup=%.2f\n", results[first + 1].mean / results[first].mean);
+        run_broadphase(results, options, map, count);
+    }
+
+    if (options.json_path && !write_bench_json(options.json_path, "bench_entities", options, results)) return 1;
+    return 0;
+}
@@ -0,0 +1,49 @@
+#ifndef MYGAME_BENCH_FIXTURES_H
+#define MYGAME_BENCH_FIXTURES_H
+
+// Wspólne dane wejściowe programów bench_*: generowana mapa testowa
+// i postacie rozstawione nad mapą. Ten sam generator (LCG) w każdym
+// programie, więc wyniki różnych benchmarków dotyczą tych samych danych.
+#include "game.h"
+#include <vector>
+
+// Następna liczba z generatora liniowego kongruencyjnego (jak rand() w glibc)
+inline unsigned bench_random(unsigned &seed) {
+    seed = seed * 1103515245u + 12345u;
+    return seed;
+}
+
+// Mapa testowa: ostatni wiersz to podłoga z dziurami (floor_hole_percent %
+// pustych kafelków), a co platform_rows wierszy (od wiersza platform_rows)
+// platformy z platform_percent % pełnych kafelków
+inline game_map_t make_bench_map(int width, int height, unsigned seed, int platform_rows, int platform_percent,
+                                 int floor_hole_percent) {
+    game_map_t map = {width, height, std::vector<int>((size_t) width * height, 0)};
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int roll = (int) ((bench_random(seed) >> 16) % 100);
+            bool solid = y == height - 1 ? roll >= floor_hole_percent
+                                         : y > 0 && y % platform_rows == 0 && roll < platform_percent;
+            map.map[(size_t) y * width + x] = solid ? 1 : 0;
+        }
+    }
+    return map;
+}
+
+// Postacie rozstawione pseudolosowo w kolumnach 1..width - 2 i wierszach
+// 1..rows, z losową prędkością poziomą i przyspieszeniem w lewo lub w prawo
+inline std::vector<player_t> make_bench_players(int count, int width, int rows = 8, unsigned seed = 12345) {
+    std::vector<player_t> players((size_t) count);
+    for (player_t &p : players) {
+        bench_random(seed);
+        p.p.v.x = 1 + (seed >> 8) % (unsigned) (width - 2);
+        p.p.v.y = 1 + (seed >> 4) % (unsigned) rows;
+        p.v.v.x = ((int) (seed % 200) - 100) * 0.05;
+        p.v.v.y = 0;
+        p.a.v.x = (seed & 1) ? 2 : -2;
+        p.a.v.y = 0;
+    }
+    return players;
+}
+
+#endif
@@ -0,0 +1,66 @@
+// Benchmark wczytywania obrazów z Image/: samo dekodowanie BMP
+// (load_image_surface), load_image z utworzeniem tekstury i budowa całego
+// atlasu (texture_atlas_t). Tekstury tworzy programowy renderer SDL na
+// powierzchni w pamięci, więc program działa bez okna.
+#include "bench.h"
+#include "render.h"
+#include <stdexcept>
+
+#ifndef MYGAME_IMAGE_DIR
+#define MYGAME_IMAGE_DIR "Image"
+#endif
+
+int main(int argc, char *argv[]) {
+    bench_options_t options;
+    options.warmup = 2;
+    options.repetitions = 10;
+    std::string dir = MYGAME_IMAGE_DIR;
+    for (int i = 1; i < argc; i++) {
+        if (parse_bench_option(argc, argv, i, options)) continue;
+        if (!std::strcmp(argv[i], "--images") && i + 1 < argc) dir = argv[++i];
+        else {
+            std::printf("usage: %s [--images DIR] %s\n", argv[0], bench_options_usage());
+            return 2;
+        }
+    }
+
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    if (!renderer) {
+        std::fprintf(stderr, "Couldn't create software renderer: %s\n", SDL_GetError());
+        return 3;
+    }
+
+    const char *names[] = {"background.bmp", "block.bmp", "player.bmp", "player2.bmp"};
+    std::vector<std::string> paths;
+    for (const char *name : names) paths.push_back(dir + "/" + name);
+
+    std::vector<bench_result_t> results;
+    try {
+        for (size_t i = 0; i < paths.size(); i++) {
+            const char *path = paths[i].c_str();
+            run_bench(results, options, std::string("load_image_surface/") + names[i], 1, [&] {
+                SDL_FreeSurface(load_image_surface(path, false));
+            });
+            run_bench(results, options, std::string("load_image/") + names[i], 1, [&] {
+                load_image(renderer, path);
+            });
+        }
+
+        std::vector<atlas_image_t> images;
+        for (size_t i = 0; i < paths.size(); i++) images.push_back({paths[i].c_str(), i >= 2});
+        run_bench(results, options, "texture_atlas_t/all", (double) images.size(), [&] {
+            texture_atlas_t atlas(renderer, images);
+        });
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s (run from the source directory or pass --images)\n", e.what());
+        return 3;
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    SDL_Quit();
+
+    if (options.json_path && !write_bench_json(options.json_path, "bench_load_image", options, results)) return 1;
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Benchmark nawigacji: budowa grafu (nav_graph_t) dla map wkompilowanych
+// i dużej mapy generowanej, zapytania A* z jednym kontekstem nav_query_t dla
+// losowych par pól oraz sprawdzenie, ile agentów sterowanych nav_steer
+// fizyką gracza dochodzi do celu z przeplanowaniem po każdym lądowaniu.
+#include "bench.h"
+#include "bench_fixtures.h"
+#include "game.h"
+#include "nav.h"
+#include "packed_map.h"
+
+// Losowe pary pól połączone ścieżką
+static std::vector<std::pair<int, int>> make_queries(const nav_graph_t &graph, int count) {
+    std::vector<std::pair<int, int>> queries;
+    if (graph.cell_count() == 0) return queries; // mapa bez pól, na których da się stanąć
+    nav_query_t query;
+    unsigned seed = 99;
+    for (int attempt = 0; (int) queries.size() < count && attempt < count * 50; attempt++) {
+        int from = (int) ((bench_random(seed) >> 8) % (unsigned) graph.cell_count());
+        int to = (int) ((bench_random(seed) >> 8) % (unsigned) graph.cell_count());
+        if (query.find_path(graph, from, to)) queries.push_back({from, to});
+    }
+    return queries;
+}
+
+// Agenci idą fizyką gracza z pól from do pól to (nav_agent_t). Zwraca
+// liczbę agentów, które dotarły w max_ticks.
+static int follow_paths(const packed_map_t &map, const nav_graph_t &graph,
+                        const std::vector<std::pair<int, int>> &queries, int max_ticks, long long &replans) {
+    const double dt = 1.0 / 60.0;
+    nav_query_t query;
+    int reached = 0;
+    for (const std::pair<int, int> &q : queries) {
+        player_t agent = {{graph.cell_column(q.first) + 0.5, (double) graph.cell_row(q.first)}, {0, 0}, {0, 0}};
+        nav_agent_t control;
+        for (int tick = 0; tick < max_ticks; tick++) {
+            if (is_on_the_ground(agent, map) && graph.cell_at(agent.p.v.x, agent.p.v.y, 0) == q.second) {
+                reached++;
+                break;
+            }
+            if (!control.control(agent, map, graph, query, q.second)) break;
+            player_t previous = agent;
+            agent = update_player(agent, map, dt);
+            if (agent.p.v.y < previous.p.v.y - 1.0) break; // spadł poniżej mapy
+        }
+        replans += control.replans;
+    }
+    return reached;
+}
+
+static void bench_map(std::vector<bench_result_t> &results, const bench_options_t &options, const char *name,
+                      const game_map_t &source, int query_count) {
+    const packed_map_t map(source);
+    run_bench(results, options, std::string("nav_build/") + name, 1, [&] {
+        nav_graph_t graph(map);
+    });
+
+    const nav_graph_t graph(map);
+    const std::vector<std::pair<int, int>> queries = make_queries(graph, query_count);
+    if (queries.empty()) {
+        std::printf("  %s: cells=%d, no connected pairs - skipping queries\n", name, graph.cell_count());
+        return;
+    }
+    nav_query_t query;
+    long long expanded = 0;
+    run_bench(results, options, std::string("nav_query/") + name, (double) queries.size(), [&] {
+        for (const std::pair<int, int> &q : queries) {
+            query.find_path(graph, q.first, q.second);
+            expanded += query.expanded;
+        }
+    });
+
+    long long replans = 0;
+    int reached = follow_paths(map, graph, queries, 60 * 60, replans);
+    std::printf("  %s: cells=%d spans=%zu links=%zu memory_bytes=%zu walk_cost=%d queries=%zu "
+                "agents_reached=%d/%zu replans=%lld\n", name, graph.cell_count(), graph.spans().size(),
+                graph.link_count(), graph.memory_bytes(), graph.walk_cost, queries.size(), reached, queries.size(),
+                replans);
+}
+
+int main(int argc, char *argv[]) {
+    bench_options_t options;
+    int query_count = 500;
+    for (int i = 1; i < argc; i++) {
+        if (parse_bench_option(argc, argv, i, options)) continue;
+        if (!std::strcmp(argv[i], "--queries") && i + 1 < argc) query_count = std::atoi(argv[++i]);
+        else {
+            std::printf("usage: %s [--queries N] %s\n", argv[0], bench_options_usage());
+            return 2;
+        }
+    }
+
+    std::vector<bench_result_t> results;
+    const char *names[] = {"game_map1", "game_map2", "game_map3"};
+    for (size_t i = 0; i < game_maps.size() && i < 3; i++) bench_map(results, options, names[i], *game_maps[i], query_count);
+    // Podłoga z dziurami i gęste platformy co trzy wiersze
+    bench_map(results, options, "generated_256x64", make_bench_map(256, 64, 7, 3, 75, 12), query_count);
+
+    if (options.json_path && !write_bench_json(options.json_path, "bench_nav", options, results)) return 1;
+    return 0;
+}
@@ -0,0 +1,95 @@
+// Benchmark fizyki: update_player na różnych typach map oraz step_entities
+// na magazynie SoA. Jedno powtórzenie to stała liczba kroków od tego samego
+// stanu początkowego.
+#include "bench.h"
+#include "bench_fixtures.h"
+#include "entities.h"
+#include "game.h"
+#include "level_file.h"
+#include "packed_map.h"
+#include "spatial_hash.h"
+#include <memory>
+#include <stdexcept>
+
+#ifndef MYGAME_LEVEL_DIR
+#define MYGAME_LEVEL_DIR "levels"
+#endif
+
+template<class map_t>
+static void bench_update_player(std::vector<bench_result_t> &results, const bench_options_t &options,
+                                const char *map_name, const map_t &map, int count, int steps) {
+    const std::vector<player_t> start = make_bench_players(count, map.width);
+    std::vector<player_t> players;
+    const double dt = 1.0 / 60.0;
+    run_bench(results, options, std::string("update_player/") + map_name, (double) count * steps, [&] {
+        players = start;
+        for (int s = 0; s < steps; s++) {
+            for (player_t &p : players) {
+                // Skok co sekundę, żeby postacie nie tylko leżały na ziemi
+                if (s % 60 == 0 && is_on_the_ground(p, map)) p.a.v.y = -500;
+                if (s % 60 == 5) p.a.v.y = 0;
+                p = update_player(p, map, dt);
+            }
+        }
+    });
+}
+
+int main(int argc, char *argv[]) {
+    bench_options_t options;
+    int count = 1000;
+    int steps = 100;
+    for (int i = 1; i < argc; i++) {
+        if (parse_bench_option(argc, argv, i, options)) continue;
+        if (!std::strcmp(argv[i], "--entities") && i + 1 < argc) count = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--steps") && i + 1 < argc) steps = std::atoi(argv[++i]);
+        else {
+            std::printf("usage: %s [--entities N] [--steps N] %s\n", argv[0], bench_options_usage());
+            return 2;
+        }
+    }
+
+    std::vector<bench_result_t> results;
+    bench_update_player(results, options, "game_map_t", game_map1, count, steps);
+    bench_update_player(results, options, "packed_map_t", packed_map_t(game_map1), count, steps);
+
+    std::unique_ptr<mapped_level_t> level;
+    try {
+        level.reset(new mapped_level_t(MYGAME_LEVEL_DIR "/level1.sgdl"));
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "skipping mapped_level_t: %s\n", e.what());
+    }
+    if (level) bench_update_player(results, options, "mapped_level_t", *level, count, steps);
+
+    // Ten sam ruch w magazynie SoA
+    const packed_map_t packed(game_map1);
+    const std::vector<player_t> start = make_bench_players(count, packed.width);
+    entity_store_t store;
+    store.reserve(count);
+    run_bench(results, options, "step_entities/packed_map_t", (double) count * steps, [&] {
+        store.count = 0;
+        for (const player_t &p : start) {
+            store.add((float) p.p.v.x, (float) p.p.v.y, (float) p.v.v.x, (float) p.v.v.y, (float) p.a.v.x, 0);
+        }
+        for (int s = 0; s < steps; s++) step_entities(store, packed, 1.0f / 60.0f);
+    });
+
+    // Faza szeroka po każdym kroku: aktualizacja siatki i wszystkie pary
+    spatial_hash_t hash;
+    long long pairs = 0;
+    run_bench(results, options, "spatial_hash/update+pairs", (double) count * steps, [&] {
+        store.count = 0;
+        hash.clear();
+        for (const player_t &p : start) {
+            store.add((float) p.p.v.x, (float) p.p.v.y, (float) p.v.v.x, (float) p.v.v.y, (float) p.a.v.x, 0);
+        }
+        for (int s = 0; s < steps; s++) {
+            step_entities(store, packed, 1.0f / 60.0f);
+            hash.update(store);
+            hash.for_each_pair(store, [&](int, int) { pairs++; });
+        }
+        bench_do_not_optimize(pairs);
+    });
+
+    if (options.json_path && !write_bench_json(options.json_path, "bench_physics", options, results)) return 1;
+    return 0;
+}
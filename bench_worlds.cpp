@@ -0,0 +1,82 @@
+// Benchmark równoległego krokowania wielu niezależnych światów (world_t):
+// czas kroku świata przy 1, 2, 4, ... wątkach aż do liczby rdzeni i
+// przyspieszenie względem pierwszego pomiaru. Suma kontrolna musi być ta sama
+// dla każdej liczby wątków.
+#include "bench.h"
+#include "determinism.h"
+#include "world.h"
+#include <cinttypes>
+#include <cstdint>
+#include <thread>
+
+int main(int argc, char *argv[]) {
+    bench_options_t options;
+    options.warmup = 1;
+    options.repetitions = 5;
+    int world_count = 4096;
+    int ticks = 500;
+    int max_threads = std::max(1, (int) std::thread::hardware_concurrency()); // 0 - nieznana
+    for (int i = 1; i < argc; i++) {
+        if (parse_bench_option(argc, argv, i, options)) continue;
+        if (!std::strcmp(argv[i], "--worlds") && i + 1 < argc) world_count = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--ticks") && i + 1 < argc) ticks = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) max_threads = std::atoi(argv[++i]);
+        else {
+            std::printf("usage: %s [--worlds N] [--ticks N] [--threads MAX] %s\n", argv[0], bench_options_usage());
+            return 2;
+        }
+    }
+    if (world_count <= 0 || ticks <= 0 || max_threads <= 0) {
+        std::printf("usage: %s [--worlds N] [--ticks N] [--threads MAX] %s\n", argv[0], bench_options_usage());
+        return 2;
+    }
+
+    std::vector<bench_result_t> results;
+    const world_levels_t levels = make_builtin_levels();
+    const double dt = 1.0 / 60.0;
+    const std::vector<world_t> start_worlds((size_t) world_count, make_world(levels));
+    double single_thread = 0;
+    uint64_t reference = 0;
+
+    for (int threads = 1;; threads *= 2) {
+        if (threads > max_threads) threads = max_threads;
+        worker_pool_t pool(threads);
+        std::vector<world_t> worlds = start_worlds;
+        std::vector<uint64_t> random_states((size_t) world_count);
+
+        // Każde powtórzenie zaczyna od tych samych światów, więc suma
+        // kontrolna po pomiarze nie zależy od liczby powtórzeń
+        size_t first = results.size();
+        run_bench(results, options, "step_worlds/threads=" + std::to_string(threads), (double) world_count * ticks,
+                  [&] {
+                      worlds = start_worlds;
+                      for (size_t i = 0; i < random_states.size(); i++) random_states[i] = i + 1;
+                  },
+                  [&] {
+                      step_worlds(pool, worlds, ticks, dt, [&](world_t &world, size_t i) {
+                          scripted_input(world.tick, random_states[i], world.player, world.map());
+                      });
+                  });
+
+        if (results.size() > first) {
+            uint64_t checksum = FNV1A_START;
+            for (const world_t &world : worlds) {
+                checksum = fnv1a(checksum, &world.player, sizeof(world.player));
+                checksum = fnv1a(checksum, &world.map_index, sizeof(world.map_index));
+            }
+            if (single_thread == 0) {
+                single_thread = results.back().mean;
+                reference = checksum;
+            }
+            std::printf("  speedup=%.2f checksum=0x%016" PRIx64 "\n", single_thread / results.back().mean, checksum);
+            if (checksum != reference) {
+                std::fprintf(stderr, "checksum differs from the first measured thread count\n");
+                return 1;
+            }
+        }
+        if (threads == max_threads) break;
+    }
+
+    if (options.json_path && !write_bench_json(options.json_path, "bench_worlds", options, results)) return 1;
+    return 0;
+}
@@ -0,0 +1,47 @@
+#ifndef MYGAME_CAMERA_H
+#define MYGAME_CAMERA_H
+
+#include "game.h"
+
+// Prostokąt kafelków: kolumny x0..x1 - 1, wiersze y0..y1 - 1
+struct tile_rect_t {
+    int x0, y0, x1, y1;
+};
+
+// Kamera przewijanego widoku: lewy górny róg widoku w pikselach świata
+// (kafelek (x, y) zajmuje piksele od x * TILE_SIZE, y * TILE_SIZE) i rozmiar
+// widoku. Położenie jest całkowite, żeby kafelki nie rozjeżdżały się o ułamek
+// piksela.
+struct camera_t {
+    int x = 0, y = 0;
+    int width = 800, height = 600;
+
+    // Środkuje widok na punkcie (px, py) w jednostkach mapy, nie wychodząc
+    // poza mapę. Mapa węższa (niższa) niż widok jest wyrównana do lewej (góry).
+    void follow(double px, double py, int map_width, int map_height) {
+        x = clamp_axis(floor_to_int(px * TILE_SIZE) - width / 2, map_width * TILE_SIZE - width);
+        y = clamp_axis(floor_to_int(py * TILE_SIZE) - height / 2, map_height * TILE_SIZE - height);
+    }
+
+    // Kafelki widoczne w kamerze poszerzone o margin kafelków z każdej
+    // strony i obcięte do mapy; rysowanie przechodzi tylko po nich
+    tile_rect_t visible_tiles(int map_width, int map_height, int margin = 1) const {
+        tile_rect_t r = {floor_to_int((double) x / TILE_SIZE) - margin,
+                         floor_to_int((double) y / TILE_SIZE) - margin,
+                         floor_to_int((double) (x + width - 1) / TILE_SIZE) + 1 + margin,
+                         floor_to_int((double) (y + height - 1) / TILE_SIZE) + 1 + margin};
+        if (r.x0 < 0) r.x0 = 0;
+        if (r.y0 < 0) r.y0 = 0;
+        if (r.x1 > map_width) r.x1 = map_width;
+        if (r.y1 > map_height) r.y1 = map_height;
+        return r;
+    }
+
+private:
+    static int clamp_axis(int v, int max) {
+        if (v > max) v = max;
+        return v < 0 ? 0 : v;
+    }
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include "chunked_map.h"
+#include <cstring>
+#include <stdexcept>
+
+chunked_map_t::chunked_map_t(int width, int height, chunk_loader_t loader, int capacity, int window_shift)
+        : width(width), height(height), loader(std::move(loader)), capacity(capacity),
+          window_shift(window_shift), window_mask((1 << window_shift) - 1) {
+    if (width <= 0 || height <= 0 || capacity <= 0 || window_shift <= 0 || window_shift > 12) {
+        throw std::invalid_argument("chunked_map_t: invalid dimensions");
+    }
+    std::memset(solid_chunk, 1, sizeof(solid_chunk));
+    window.assign((size_t) 1 << (2 * window_shift), {chunk_key(-1, -1), solid_chunk, -1});
+    // Cała pula od razu - wskaźniki do kafelków w oknie nigdy się nie przesuwają
+    pool.resize(capacity);
+    index.reserve(capacity);
+}
+
+size_t chunked_map_t::memory_bytes() const {
+    return pool.size() * sizeof(chunk_t) + window.size() * sizeof(window_slot_t) + sizeof(*this);
+}
+
+void chunked_map_t::lru_unlink(int i) {
+    chunk_t &c = pool[i];
+    if (c.prev >= 0) pool[c.prev].next = c.next; else lru_head = c.next;
+    if (c.next >= 0) pool[c.next].prev = c.prev; else lru_tail = c.prev;
+    c.prev = c.next = -1;
+}
+
+void chunked_map_t::lru_push_front(int i) {
+    chunk_t &c = pool[i];
+    c.prev = -1;
+    c.next = lru_head;
+    if (lru_head >= 0) pool[lru_head].prev = i;
+    lru_head = i;
+    if (lru_tail < 0) lru_tail = i;
+}
+
+int chunked_map_t::acquire(int cx, int cy) {
+    uint64_t key = chunk_key(cx, cy);
+    auto found = index.find(key);
+    if (found != index.end()) {
+        lru_unlink(found->second);
+        lru_push_front(found->second);
+        return found->second;
+    }
+
+    int i;
+    if ((int) index.size() < capacity) {
+        i = (int) index.size();
+    } else {
+        // Usunięcie najdawniej używanego chunka (także z okna)
+        i = lru_tail;
+        lru_unlink(i);
+        index.erase(pool[i].key);
+        if (pool[i].slot >= 0) window[pool[i].slot] = {chunk_key(-1, -1), solid_chunk, -1};
+        evictions++;
+    }
+
+    chunk_t &c = pool[i];
+    c.key = key;
+    c.slot = -1;
+    loader(cx, cy, c.tiles);
+    // Kafelki poza światem (ostatni niepełny chunk) są pełne, jak w game_map_t::get
+    for (int y = 0; y < CHUNK_SIZE; y++) {
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            if ((cx << CHUNK_SHIFT) + x >= width || (cy << CHUNK_SHIFT) + y >= height) {
+                c.tiles[(y << CHUNK_SHIFT) | x] = 1;
+            }
+        }
+    }
+    index.emplace(key, i);
+    lru_push_front(i);
+    loads++;
+    return i;
+}
+
+void chunked_map_t::stream_around(double x, double y, int radius) {
+    // Wczytywany obszar musi mieścić się w oknie i w puli
+    int max_radius = ((1 << window_shift) - 1) / 2;
+    if (radius > max_radius) radius = max_radius;
+    while (radius > 0 && (2 * radius + 1) * (2 * radius + 1) > capacity) radius--;
+
+    int center_x = (int) x >> CHUNK_SHIFT;
+    int center_y = (int) y >> CHUNK_SHIFT;
+    for (int cy = center_y - radius; cy <= center_y + radius; cy++) {
+        if (cy < 0 || cy >= chunks_y()) continue;
+        for (int cx = center_x - radius; cx <= center_x + radius; cx++) {
+            if (cx < 0 || cx >= chunks_x()) continue;
+            window_slot_t &slot = window[((cy & window_mask) << window_shift) | (cx & window_mask)];
+            if (slot.key == chunk_key(cx, cy)) {
+                // Chunk już w oknie - tylko odświeżenie pozycji w LRU
+                lru_unlink(slot.chunk);
+                lru_push_front(slot.chunk);
+                continue;
+            }
+            int i = acquire(cx, cy);
+            if (slot.chunk >= 0) pool[slot.chunk].slot = -1;
+            slot = {chunk_key(cx, cy), pool[i].tiles, i};
+            pool[i].slot = (int) (&slot - window.data());
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef MYGAME_CHUNKED_MAP_H
+#define MYGAME_CHUNKED_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#define CHUNK_SHIFT 5
+#define CHUNK_SIZE (1 << CHUNK_SHIFT) // 32x32 kafelków w chunku
+
+// Źródło chunków: wypełnia CHUNK_SIZE * CHUNK_SIZE kafelków chunka (cx, cy),
+// wiersz po wierszu. Może generować świat albo czytać go z pliku.
+typedef std::function<void(int cx, int cy, uint8_t *tiles)> chunk_loader_t;
+
+// Mapa świata podzielona na chunki ładowane na żądanie wokół gracza.
+// W pamięci jest najwyżej `capacity` chunków; najdawniej używane są
+// usuwane (LRU), więc zużycie pamięci nie zależy od rozmiaru świata.
+//
+// get(x, y) ma ten sam kontrakt co game_map_t::get, ale nie sprawdza granic:
+// adres chunka pochodzi z okna (window) indeksowanego maską współrzędnych,
+// a chunk spoza świata lub jeszcze niewczytany zastępowany jest pełnym
+// chunkiem (same jedynki) przez wybór bez skoku warunkowego.
+class chunked_map_t {
+public:
+    int width, height; // rozmiar świata w kafelkach
+
+    // window_shift: okno ma (1 << window_shift)^2 chunków i musi obejmować
+    // obszar wczytywany przez stream_around()
+    chunked_map_t(int width, int height, chunk_loader_t loader, int capacity = 256, int window_shift = 4);
+
+    chunked_map_t(const chunked_map_t &) = delete;
+    chunked_map_t &operator=(const chunked_map_t &) = delete;
+
+    int get(int x, int y) const {
+        int cx = x >> CHUNK_SHIFT;
+        int cy = y >> CHUNK_SHIFT;
+        const window_slot_t &slot = window[((cy & window_mask) << window_shift) | (cx & window_mask)];
+        const uint8_t *tiles = slot.key == chunk_key(cx, cy) ? slot.tiles : solid_chunk;
+        return tiles[((y & (CHUNK_SIZE - 1)) << CHUNK_SHIFT) | (x & (CHUNK_SIZE - 1))];
+    }
+
+    // Wczytuje (lub odświeża w LRU) chunki w promieniu radius chunków
+    // wokół punktu (x, y) w kafelkach. Wywoływane raz na krok fizyki.
+    void stream_around(double x, double y, int radius = 1);
+
+    int chunks_x() const { return (width + CHUNK_SIZE - 1) >> CHUNK_SHIFT; }
+    int chunks_y() const { return (height + CHUNK_SIZE - 1) >> CHUNK_SHIFT; }
+    size_t resident_chunks() const { return index.size(); }
+    size_t memory_bytes() const;
+
+    long long loads = 0;     // liczba wczytanych chunków
+    long long evictions = 0; // liczba usuniętych chunków
+
+private:
+    struct chunk_t {
+        uint64_t key;
+        int prev, next; // lista LRU (indeksy w pool), -1 = brak
+        int slot;       // pozycja w oknie, -1 = poza oknem
+        uint8_t tiles[CHUNK_SIZE * CHUNK_SIZE];
+    };
+
+    struct window_slot_t {
+        uint64_t key;
+        const uint8_t *tiles;
+        int chunk;
+    };
+
+    static uint64_t chunk_key(int cx, int cy) {
+        return ((uint64_t) (uint32_t) cy << 32) | (uint32_t) cx;
+    }
+
+    int acquire(int cx, int cy);
+    void lru_unlink(int i);
+    void lru_push_front(int i);
+
+    chunk_loader_t loader;
+    int capacity;
+    int window_shift;
+    int window_mask;
+    std::vector<window_slot_t> window;
+    std::vector<chunk_t> pool;
+    std::unordered_map<uint64_t, int> index; // klucz chunka -> indeks w pool
+    int lru_head = -1, lru_tail = -1;
+    uint8_t solid_chunk[CHUNK_SIZE * CHUNK_SIZE];
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef MYGAME_COLLISION_H
+#define MYGAME_COLLISION_H
+
+#include "packed_map.h"
+
+// Prostokąt kolizji względem pozycji obiektu: pozycja to środek dolnej
+// krawędzi (stopy gracza), prostokąt zajmuje x - half_width .. x + half_width
+// oraz y - height .. y.
+struct aabb_t {
+    double half_width;
+    double height;
+};
+
+// Wynik przesunięcia prostokąta po siatce kafelków
+struct sweep_result_t {
+    double x, y;          // pozycja po rozwiązaniu kolizji
+    int normal_x;         // normalna kontaktu w osi x: -1 (ściana z prawej), 1 (z lewej), 0
+    int normal_y;         // normalna kontaktu w osi y: -1 (podłoże), 1 (sufit), 0
+};
+
+// Zaokrąglenie w dół bez wywołania std::floor (bez SSE4.1 to wywołanie libm)
+inline int floor_to_int(double v) {
+    int i = (int) v;
+    return i - (v < i);
+}
+
+// Czy w wierszu y, w kolumnach x0..x1, jest pełny kafelek mapy. Kafelki
+// spoza mapy są tu puste, żeby gracz mógł wyjść za krawędź (przejście
+// między poziomami) i spaść poniżej mapy (reset).
+template<class map_t>
+bool solid_in_span(const map_t &map, int x0, int x1, int y) {
+    if (y < 0 || y >= map.height) return false;
+    if (x0 < 0) x0 = 0;
+    if (x1 >= map.width) x1 = map.width - 1;
+    for (int x = x0; x <= x1; x++) {
+        if (map.get(x, y) > 0) return true;
+    }
+    return false;
+}
+
+// Wersja dla packed_map_t liczona słowami warstwy kolizji
+inline bool solid_in_span(const packed_map_t &map, int x0, int x1, int y) {
+    if (y < 0 || y >= map.height) return false;
+    if (x0 < 0) x0 = 0;
+    if (x1 >= map.width) x1 = map.width - 1;
+    return map.any_solid_in_span(x0, x1, y);
+}
+
+// Czy w kolumnie x, w wierszach y0..y1, jest pełny kafelek mapy
+template<class map_t>
+bool solid_in_column(const map_t &map, int x, int y0, int y1) {
+    if (x < 0 || x >= map.width) return false;
+    if (y0 < 0) y0 = 0;
+    if (y1 >= map.height) y1 = map.height - 1;
+    for (int y = y0; y <= y1; y++) {
+        if (map.get(x, y) > 0) return true;
+    }
+    return false;
+}
+
+// Przesunięcie prostokąta o (dx, dy) z rozwiązaniem kolizji osobno dla osi x
+// i y. W każdej osi sprawdzane są po kolei wszystkie kolumny (wiersze)
+// kafelków, przez które przechodzi krawędź prowadząca, więc szybki obiekt nie
+// przeniknie przez cienką ścianę. Nic nie jest alokowane.
+template<class map_t>
+sweep_result_t sweep_aabb(const map_t &map, const aabb_t &box, double x, double y, double dx, double dy) {
+    const double eps = 1e-9;
+    sweep_result_t result = {x, y, 0, 0};
+
+    // Oś x: wiersze zajmowane przez prostokąt
+    int row0 = floor_to_int(y - box.height);
+    int row1 = floor_to_int(y - eps);
+    if (dx > 0) {
+        double right = x + box.half_width;
+        int from = floor_to_int(right - eps) + 1;
+        int to = floor_to_int(right + dx - eps);
+        result.x = x + dx;
+        for (int col = from; col <= to; col++) {
+            if (solid_in_column(map, col, row0, row1)) {
+                result.x = col - box.half_width;
+                result.normal_x = -1;
+                break;
+            }
+        }
+    } else if (dx < 0) {
+        double left = x - box.half_width;
+        int from = floor_to_int(left) - 1;
+        int to = floor_to_int(left + dx);
+        result.x = x + dx;
+        for (int col = from; col >= to; col--) {
+            if (solid_in_column(map, col, row0, row1)) {
+                result.x = col + 1 + box.half_width;
+                result.normal_x = 1;
+                break;
+            }
+        }
+    }
+
+    // Oś y: kolumny zajmowane przez prostokąt po ruchu w osi x
+    int col0 = floor_to_int(result.x - box.half_width);
+    int col1 = floor_to_int(result.x + box.half_width - eps);
+    if (dy > 0) {
+        int from = floor_to_int(y - eps) + 1;
+        int to = floor_to_int(y + dy - eps);
+        result.y = y + dy;
+        for (int row = from; row <= to; row++) {
+            if (solid_in_span(map, col0, col1, row)) {
+                result.y = row;
+                result.normal_y = -1;
+                break;
+            }
+        }
+    } else if (dy < 0) {
+        double top = y - box.height;
+        int from = floor_to_int(top) - 1;
+        int to = floor_to_int(top + dy);
+        result.y = y + dy;
+        for (int row = from; row >= to; row--) {
+            if (solid_in_span(map, col0, col1, row)) {
+                result.y = row + 1 + box.height;
+                result.normal_y = 1;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,177 @@
+#include "collision_rects.h"
+#include <algorithm>
+#include <cmath>
+
+void collision_rects_t::build(const std::vector<uint8_t> &solid) {
+    rects_.clear();
+
+    // Odcinki poprzedniego wiersza (indeksy prostokątów, rosnąco po x0)
+    std::vector<int32_t> previous, current;
+    for (int y = 0; y < height; y++) {
+        current.clear();
+        size_t p = 0;
+        const uint8_t *row = &solid[(size_t) y * width];
+        for (int x = 0; x < width;) {
+            if (!row[x]) {
+                x++;
+                continue;
+            }
+            int x0 = x;
+            while (x < width && row[x]) x++;
+
+            // Odcinek o tych samych kolumnach wiersz wyżej - przedłużenie prostokąta w dół
+            while (p < previous.size() && rects_[previous[p]].x0 < x0) p++;
+            if (p < previous.size() && rects_[previous[p]].x0 == x0 && rects_[previous[p]].x1 == x) {
+                rects_[previous[p]].y1 = y + 1;
+                current.push_back(previous[p]);
+            } else {
+                rects_.push_back({x0, y, x, y + 1});
+                current.push_back((int32_t) rects_.size() - 1);
+            }
+        }
+        previous.swap(current);
+    }
+
+    // Kubełki: zliczenie, przesunięcia, wypełnienie
+    const int bucket = 1 << COLLISION_BUCKET_SHIFT;
+    buckets_x = (width + bucket - 1) >> COLLISION_BUCKET_SHIFT;
+    buckets_y = (height + bucket - 1) >> COLLISION_BUCKET_SHIFT;
+    bucket_first.assign((size_t) buckets_x * buckets_y + 1, 0);
+    auto for_each_bucket = [&](const solid_rect_t &r, auto fn) {
+        for (int by = r.y0 >> COLLISION_BUCKET_SHIFT; by <= (r.y1 - 1) >> COLLISION_BUCKET_SHIFT; by++) {
+            for (int bx = r.x0 >> COLLISION_BUCKET_SHIFT; bx <= (r.x1 - 1) >> COLLISION_BUCKET_SHIFT; bx++) {
+                fn(by * buckets_x + bx);
+            }
+        }
+    };
+    for (const solid_rect_t &r : rects_) for_each_bucket(r, [&](int b) { bucket_first[b + 1]++; });
+    for (size_t b = 1; b < bucket_first.size(); b++) bucket_first[b] += bucket_first[b - 1];
+    bucket_items.resize((size_t) bucket_first.back());
+    std::vector<int32_t> fill(bucket_first.begin(), bucket_first.end() - 1);
+    for (size_t i = 0; i < rects_.size(); i++) {
+        for_each_bucket(rects_[i], [&](int b) { bucket_items[fill[b]++] = (int32_t) i; });
+    }
+}
+
+bool collision_rects_t::any_solid_in_tiles(int x0, int y0, int x1, int y1) const {
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= width) x1 = width - 1;
+    if (y1 >= height) y1 = height - 1;
+    if (x0 > x1 || y0 > y1) return false;
+    // Wystarczy pierwsze trafienie, więc bez pomijania powtórzeń z visit_tiles
+    for (int by = y0 >> COLLISION_BUCKET_SHIFT; by <= y1 >> COLLISION_BUCKET_SHIFT; by++) {
+        for (int bx = x0 >> COLLISION_BUCKET_SHIFT; bx <= x1 >> COLLISION_BUCKET_SHIFT; bx++) {
+            int b = by * buckets_x + bx;
+            for (int k = bucket_first[b]; k < bucket_first[b + 1]; k++) {
+                const solid_rect_t &r = rects_[bucket_items[k]];
+                if (r.x0 <= x1 && r.x1 > x0 && r.y0 <= y1 && r.y1 > y0) return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool collision_rects_t::overlaps(double x0, double y0, double x1, double y1) const {
+    bool found = false;
+    for_each_overlapping(x0, y0, x1, y1, [&](int) { found = true; });
+    return found;
+}
+
+// Przecięcie promienia z prostokątem metodą płyt: najbliższe t w 0..max_t
+// i normalna ściany wejścia; false, gdy promień omija prostokąt
+static bool ray_rect(double x, double y, double dx, double dy, double max_t, const solid_rect_t &r, double &t,
+                     int &normal_x, int &normal_y) {
+    double t_min = 0, t_max = max_t;
+    normal_x = normal_y = 0;
+    if (dx == 0) {
+        if (x < r.x0 || x >= r.x1) return false;
+    } else {
+        double t0 = (r.x0 - x) / dx, t1 = (r.x1 - x) / dx;
+        if (t0 > t1) std::swap(t0, t1);
+        if (t0 > t_min) {
+            t_min = t0;
+            normal_x = dx > 0 ? -1 : 1;
+        }
+        if (t1 < t_max) t_max = t1;
+    }
+    if (dy == 0) {
+        if (y < r.y0 || y >= r.y1) return false;
+    } else {
+        double t0 = (r.y0 - y) / dy, t1 = (r.y1 - y) / dy;
+        if (t0 > t1) std::swap(t0, t1);
+        if (t0 > t_min) {
+            t_min = t0;
+            normal_x = 0;
+            normal_y = dy > 0 ? -1 : 1;
+        }
+        if (t1 < t_max) t_max = t1;
+    }
+    if (t_min >= t_max) return false;
+    t = t_min;
+    return true;
+}
+
+bool collision_rects_t::raycast(double x, double y, double dx, double dy, double max_distance, ray_hit_t &hit) const {
+    double length = std::sqrt(dx * dx + dy * dy);
+    if (length == 0 || width == 0 || height == 0) return false;
+    dx /= length;
+    dy /= length;
+
+    // Odcinek promienia wewnątrz mapy
+    const solid_rect_t bounds = {0, 0, width, height};
+    double t, t_end = max_distance;
+    int nx, ny;
+    if (!ray_rect(x, y, dx, dy, max_distance, bounds, t, nx, ny)) return false;
+    {
+        double t0 = dx > 0 ? (width - x) / dx : dx < 0 ? -x / dx : max_distance;
+        double t1 = dy > 0 ? (height - y) / dy : dy < 0 ? -y / dy : max_distance;
+        t_end = std::min(t_end, std::min(t0, t1));
+    }
+
+    // Przejście po kubełkach wzdłuż promienia (DDA o kroku kubełka)
+    const double bucket = (double) (1 << COLLISION_BUCKET_SHIFT);
+    double sx = x + dx * t, sy = y + dy * t;
+    int bx = std::min(buckets_x - 1, std::max(0, floor_to_int(sx / bucket)));
+    int by = std::min(buckets_y - 1, std::max(0, floor_to_int(sy / bucket)));
+    const int step_x = dx > 0 ? 1 : -1, step_y = dy > 0 ? 1 : -1;
+    double next_x = dx != 0 ? ((bx + (dx > 0)) * bucket - x) / dx : INFINITY;
+    double next_y = dy != 0 ? ((by + (dy > 0)) * bucket - y) / dy : INFINITY;
+    const double delta_x = dx != 0 ? bucket / std::fabs(dx) : INFINITY;
+    const double delta_y = dy != 0 ? bucket / std::fabs(dy) : INFINITY;
+
+    hit.distance = INFINITY;
+    hit.rect = -1;
+    for (;;) {
+        int b = by * buckets_x + bx;
+        for (int k = bucket_first[b]; k < bucket_first[b + 1]; k++) {
+            const solid_rect_t &r = rects_[bucket_items[k]];
+            double rt;
+            if (ray_rect(x, y, dx, dy, max_distance, r, rt, nx, ny) && rt < hit.distance) {
+                hit.distance = rt;
+                hit.normal_x = nx;
+                hit.normal_y = ny;
+                hit.rect = bucket_items[k];
+            }
+        }
+        // Trafienie przed wyjściem z kubełka jest najbliższe - dalsze kubełki leżą za nim
+        double exit_t = std::min(next_x, next_y);
+        if (hit.distance <= exit_t || exit_t >= t_end) break;
+        if (next_x < next_y) {
+            bx += step_x;
+            next_x += delta_x;
+        } else {
+            by += step_y;
+            next_y += delta_y;
+        }
+        if (bx < 0 || bx >= buckets_x || by < 0 || by >= buckets_y) break;
+    }
+    if (hit.rect < 0) return false;
+    hit.x = x + dx * hit.distance;
+    hit.y = y + dy * hit.distance;
+    return true;
+}
+
+size_t collision_rects_t::memory_bytes() const {
+    return rects_.size() * sizeof(solid_rect_t) + (bucket_first.size() + bucket_items.size()) * sizeof(int32_t);
+}
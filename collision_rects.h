@@ -0,0 +1,144 @@
+#ifndef MYGAME_COLLISION_RECTS_H
+#define MYGAME_COLLISION_RECTS_H
+
+#include "collision.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bok kubełka siatki indeksu: 1 << COLLISION_BUCKET_SHIFT kafelków
+#define COLLISION_BUCKET_SHIFT 3
+
+// Prostokąt pełnych kafelków: kolumny x0..x1 - 1, wiersze y0..y1 - 1
+struct solid_rect_t {
+    int32_t x0, y0, x1, y1;
+};
+
+// Trafienie promienia w prostokąt
+struct ray_hit_t {
+    double distance;        // odległość od początku promienia (w kafelkach)
+    double x, y;            // punkt trafienia
+    int normal_x, normal_y; // normalna ściany jak w sweep_result_t; 0, 0 - początek w prostokącie
+    int rect;               // indeks w rects()
+};
+
+// Pełne kafelki mapy scalone w prostokąty: najpierw najdłuższe odcinki
+// w każdym wierszu, potem odcinki o tych samych kolumnach w kolejnych
+// wierszach w jeden prostokąt. Długa podłoga to jeden prostokąt zamiast
+// kilkudziesięciu kafelków. Prostokąty są zapisane w kubełkach równomiernej
+// siatki (każdy w kubełkach, które pokrywa), więc zapytanie przegląda tylko
+// prostokąty z okolicy. Budowane raz przy wczytaniu mapy; zapytania tylko
+// czytają i mogą działać z wielu wątków naraz.
+//
+// Jak packed_map_t może zastąpić mapę w fizyce (update_player, sweep_aabb,
+// step_entities) - przeciążenia solid_in_span i solid_in_column niżej dają
+// te same wyniki co kafelki, więc zysk rośnie z szerokością obiektu.
+class collision_rects_t {
+public:
+    int width = 0, height = 0;
+
+    collision_rects_t() = default;
+
+    // Buduje z dowolnej mapy z polami width, height i metodą get(x, y);
+    // kafelek jest pełny, gdy get(x, y) > 0 (jak w is_in_collision)
+    template<class map_t>
+    explicit collision_rects_t(const map_t &map) : width(map.width), height(map.height) {
+        std::vector<uint8_t> solid((size_t) width * height);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) solid[(size_t) y * width + x] = map.get(x, y) > 0;
+        }
+        build(solid);
+    }
+
+    // Kontrakt game_map_t::get: 1 dla pełnego kafelka i poza mapą
+    int get(int x, int y) const {
+        if (x < 0 || x >= width || y < 0 || y >= height) return 1;
+        return any_solid_in_tiles(x, y, x, y);
+    }
+
+    const std::vector<solid_rect_t> &rects() const { return rects_; }
+
+    // Wywołuje fn(i) raz dla każdego prostokąta, który nachodzi na
+    // prostokąt x0..x1, y0..y1 (w jednostkach mapy, styk krawędzi się nie liczy)
+    template<class fn_t>
+    void for_each_overlapping(double x0, double y0, double x1, double y1, fn_t fn) const;
+
+    bool overlaps(double x0, double y0, double x1, double y1) const;
+
+    // Czy prostokąt kafelków x0..x1, y0..y1 (włącznie) zawiera pełny kafelek
+    bool any_solid_in_tiles(int x0, int y0, int x1, int y1) const;
+
+    // Pierwszy prostokąt na promieniu z (x, y) w kierunku (dx, dy) nie
+    // dalej niż max_distance kafelków; false, gdy promień nic nie trafia
+    bool raycast(double x, double y, double dx, double dy, double max_distance, ray_hit_t &hit) const;
+
+    size_t memory_bytes() const;
+
+private:
+    void build(const std::vector<uint8_t> &solid);
+
+    // fn(i) dla prostokątów nachodzących na kafelki x0..x1, y0..y1
+    // (już obcięte do mapy); fn zwraca false, żeby przerwać
+    template<class fn_t>
+    bool visit_tiles(int x0, int y0, int x1, int y1, fn_t fn) const;
+
+    int buckets_x = 0, buckets_y = 0;
+    std::vector<solid_rect_t> rects_;
+    std::vector<int32_t> bucket_first; // prostokąty kubełka b: bucket_items[bucket_first[b] .. bucket_first[b + 1])
+    std::vector<int32_t> bucket_items;
+};
+
+template<class fn_t>
+bool collision_rects_t::visit_tiles(int x0, int y0, int x1, int y1, fn_t fn) const {
+    for (int by = y0 >> COLLISION_BUCKET_SHIFT; by <= y1 >> COLLISION_BUCKET_SHIFT; by++) {
+        for (int bx = x0 >> COLLISION_BUCKET_SHIFT; bx <= x1 >> COLLISION_BUCKET_SHIFT; bx++) {
+            int b = by * buckets_x + bx;
+            for (int k = bucket_first[b]; k < bucket_first[b + 1]; k++) {
+                const solid_rect_t &r = rects_[bucket_items[k]];
+                if (r.x0 > x1 || r.x1 <= x0 || r.y0 > y1 || r.y1 <= y0) continue;
+                // Prostokąt leży w kilku kubełkach - zgłasza go tylko kubełek z
+                // lewym górnym rogiem części wspólnej z zapytaniem
+                int rx = r.x0 > x0 ? r.x0 : x0;
+                int ry = r.y0 > y0 ? r.y0 : y0;
+                if ((rx >> COLLISION_BUCKET_SHIFT) != bx || (ry >> COLLISION_BUCKET_SHIFT) != by) continue;
+                if (!fn(bucket_items[k])) return false;
+            }
+        }
+    }
+    return true;
+}
+
+template<class fn_t>
+void collision_rects_t::for_each_overlapping(double x0, double y0, double x1, double y1, fn_t fn) const {
+    const double eps = 1e-9;
+    int tx0 = floor_to_int(x0), ty0 = floor_to_int(y0);
+    int tx1 = floor_to_int(x1 - eps), ty1 = floor_to_int(y1 - eps);
+    if (tx0 < 0) tx0 = 0;
+    if (ty0 < 0) ty0 = 0;
+    if (tx1 >= width) tx1 = width - 1;
+    if (ty1 >= height) ty1 = height - 1;
+    if (tx0 > tx1 || ty0 > ty1) return;
+    visit_tiles(tx0, ty0, tx1, ty1, [&](int i) {
+        const solid_rect_t &r = rects_[i];
+        if (r.x0 < x1 && r.x1 > x0 && r.y0 < y1 && r.y1 > y0) fn(i);
+        return true;
+    });
+}
+
+// Wersje dla collision_rects_t liczone prostokątami (kafelki spoza mapy
+// są puste, jak w szablonach z collision.h)
+inline bool solid_in_span(const collision_rects_t &map, int x0, int x1, int y) {
+    if (y < 0 || y >= map.height) return false;
+    if (x0 < 0) x0 = 0;
+    if (x1 >= map.width) x1 = map.width - 1;
+    return x0 <= x1 && map.any_solid_in_tiles(x0, y, x1, y);
+}
+
+inline bool solid_in_column(const collision_rects_t &map, int x, int y0, int y1) {
+    if (x < 0 || x >= map.width) return false;
+    if (y0 < 0) y0 = 0;
+    if (y1 >= map.height) y1 = map.height - 1;
+    return y0 <= y1 && map.any_solid_in_tiles(x, y0, x, y1);
+}
+
+#endif
@@ -0,0 +1,70 @@
+#include "cow_map.h"
+#include <cstring>
+
+void cow_map_t::init(int map_width, int map_height) {
+    width = map_width;
+    height = map_height;
+    blocks_x = (width + COW_BLOCK_SIZE - 1) >> COW_BLOCK_SHIFT;
+    int blocks_y = (height + COW_BLOCK_SIZE - 1) >> COW_BLOCK_SHIFT;
+    current.resize((size_t) blocks_x * blocks_y);
+    data.resize(current.size());
+    for (size_t b = 0; b < current.size(); b++) {
+        current[b] = allocate_block();
+        data[b] = blocks[current[b]].tiles;
+        std::memset(data[b], 0, sizeof(block_t::tiles));
+    }
+}
+
+int32_t cow_map_t::allocate_block() {
+    if (free_blocks.empty()) {
+        blocks.emplace_back();
+        // Zwalnianie bloków (przy przywracaniu) nie może alokować
+        free_blocks.reserve(blocks.size());
+        blocks.back().refs = 1;
+        return (int32_t) blocks.size() - 1;
+    }
+    int32_t id = free_blocks.back();
+    free_blocks.pop_back();
+    blocks[id].refs = 1;
+    return id;
+}
+
+void cow_map_t::unref(int32_t id) {
+    if (--blocks[id].refs == 0) free_blocks.push_back(id);
+}
+
+void cow_map_t::set(int x, int y, int value) {
+    if (x < 0 || x >= width || y < 0 || y >= height) return;
+    int b = (y >> COW_BLOCK_SHIFT) * blocks_x + (x >> COW_BLOCK_SHIFT);
+    if (blocks[current[b]].refs > 1) {
+        int32_t copy = allocate_block();
+        std::memcpy(blocks[copy].tiles, blocks[current[b]].tiles, sizeof(block_t::tiles));
+        unref(current[b]);
+        current[b] = copy;
+        data[b] = blocks[copy].tiles;
+    }
+    *tile_ptr(x, y) = (uint8_t) value;
+    revision++;
+}
+
+void cow_map_t::capture(int32_t *ids) {
+    for (size_t b = 0; b < current.size(); b++) {
+        ids[b] = current[b];
+        blocks[current[b]].refs++;
+    }
+}
+
+void cow_map_t::restore(const int32_t *ids) {
+    for (size_t b = 0; b < current.size(); b++) {
+        if (current[b] == ids[b]) continue;
+        blocks[ids[b]].refs++;
+        unref(current[b]);
+        current[b] = ids[b];
+        data[b] = blocks[ids[b]].tiles;
+    }
+    revision++;
+}
+
+void cow_map_t::release(const int32_t *ids) {
+    for (size_t b = 0; b < current.size(); b++) unref(ids[b]);
+}
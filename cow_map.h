@@ -0,0 +1,84 @@
+#ifndef MYGAME_COW_MAP_H
+#define MYGAME_COW_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#define COW_BLOCK_SHIFT 4
+#define COW_BLOCK_SIZE (1 << COW_BLOCK_SHIFT) // 16x16 kafelków w bloku
+
+// Zmienna mapa kafelków z kopiowaniem przy zapisie, do zapisów stanu gry
+// (snapshot_ring_t). Kafelki są podzielone na bloki COW_BLOCK_SIZE^2 ze
+// wspólnej puli z licznikami odwołań: zapis stanu tylko zwiększa liczniki
+// bloków, a set() kopiuje blok dopiero wtedy, gdy jest on też częścią
+// zapisanego stanu. Przywrócenie stanu podmienia numery bloków - bez
+// kopiowania kafelków i bez alokacji.
+//
+// Interfejs jak game_map_t (width, height, get zwracające 1 poza mapą),
+// więc fizyka działa na tej mapie bez zmian.
+class cow_map_t {
+public:
+    int width, height;
+    unsigned revision = 0; // zwiększany przy każdej zmianie kafelka i przywróceniu
+
+    // Kopia dowolnej mapy z polami width, height i metodą get(x, y)
+    template<class map_t>
+    explicit cow_map_t(const map_t &map) {
+        init(map.width, map.height);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                tile_ptr(x, y)[0] = (uint8_t) map.get(x, y);
+            }
+        }
+    }
+
+    cow_map_t(const cow_map_t &) = delete;
+    cow_map_t &operator=(const cow_map_t &) = delete;
+
+    int get(int x, int y) const {
+        if (x < 0 || x >= width || y < 0 || y >= height) return 1;
+        return *tile_ptr(x, y);
+    }
+
+    // Zmiana kafelka; współdzielony blok jest najpierw kopiowany
+    void set(int x, int y, int value);
+
+    int block_count() const { return (int) current.size(); }
+
+    // Zapis stanu: numery bieżących bloków do ids (block_count() elementów),
+    // z odwołaniem do każdego
+    void capture(int32_t *ids);
+
+    // Przywraca bloki zapisane przez capture(); zapis nadal je trzyma
+    void restore(const int32_t *ids);
+
+    // Zwalnia odwołania zapisu z capture()
+    void release(const int32_t *ids);
+
+    size_t pool_blocks() const { return blocks.size(); } // bloki w puli (także wolne)
+
+private:
+    struct block_t {
+        uint8_t tiles[COW_BLOCK_SIZE * COW_BLOCK_SIZE];
+        int32_t refs;
+    };
+
+    int blocks_x = 0;
+    std::deque<block_t> blocks;   // pula; deque nie przenosi bloków przy dokładaniu
+    std::vector<int32_t> free_blocks;
+    std::vector<int32_t> current; // numer bloku dla każdej pozycji bloku mapy
+    std::vector<uint8_t *> data;  // tiles bieżących bloków (bez przeliczania numeru w get)
+
+    void init(int map_width, int map_height);
+    int32_t allocate_block();
+    void unref(int32_t id);
+
+    uint8_t *tile_ptr(int x, int y) const {
+        int b = (y >> COW_BLOCK_SHIFT) * blocks_x + (x >> COW_BLOCK_SHIFT);
+        return data[b] + (((y & (COW_BLOCK_SIZE - 1)) << COW_BLOCK_SHIFT) | (x & (COW_BLOCK_SIZE - 1)));
+    }
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef MYGAME_DETERMINISM_H
+#define MYGAME_DETERMINISM_H
+
+// Wspólne części deterministycznych przebiegów (mygame_sim, bench_worlds,
+// log wejścia, generator poziomów): generator pseudolosowy, suma kontrolna
+// i skrypt wejścia. Jedna kopia, więc ten sam seed i te same bajty dają
+// ten sam wynik w każdym programie.
+#include "game.h"
+#include <cstddef>
+#include <cstdint>
+
+// Generator pseudolosowy xorshift64 - ten sam ciąg dla tego samego ziarna
+// (stan nie może być zerem)
+inline uint64_t next_random(uint64_t &state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Suma kontrolna FNV-1a (64 bity); start od FNV1A_START
+const uint64_t FNV1A_START = 0xcbf29ce484222325ULL;
+
+inline uint64_t fnv1a(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *) data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Skrypt wejścia: co pół sekundy wciśnięcie lub puszczenie klawisza,
+// z tymi samymi regułami co obsługa SDL_KEYDOWN/SDL_KEYUP w grze
+template<class map_t>
+void scripted_input(long long tick, uint64_t &random_state, player_t &player, const map_t &map) {
+    if (tick % 30 != 0) return;
+    switch (next_random(random_state) % 6) {
+        case 0:
+        case 1:
+            if (is_on_the_ground(player, map)) player.a.v.x = 2;
+            break;
+        case 2:
+            if (is_on_the_ground(player, map)) player.a.v.x = -2;
+            break;
+        case 3:
+            if (is_on_the_ground(player, map)) player.a.v.y = -500;
+            break;
+        case 4:
+            player.a.v.y = 0;
+            break;
+        case 5:
+            player.a.v.x = 0;
+            break;
+    }
+}
+
+#endif
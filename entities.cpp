@@ -0,0 +1,94 @@
+#include "entities.h"
+#include <stdexcept>
+
+static size_t padded_size(size_t count) {
+    return (count + ENTITY_BATCH - 1) / ENTITY_BATCH * ENTITY_BATCH;
+}
+
+void entity_store_t::resize_arrays(size_t size) {
+    for (std::vector<float> *a : {&x, &y, &vx, &vy, &ax, &ay, &spawn_x, &spawn_y, &grounded, &dx, &dy}) {
+        a->resize(size, 0.0f);
+    }
+    needs_sweep.resize(size, 0);
+}
+
+void entity_store_t::reserve(int capacity) {
+    size_t size = padded_size((size_t) capacity);
+    if (size > x.size()) resize_arrays(size);
+}
+
+int entity_store_t::add(float px, float py, float pvx, float pvy, float pax, float pay) {
+    int i = count;
+    if ((size_t) i >= x.size()) resize_arrays(padded_size(x.size() * 2 + 1));
+    x[i] = px;
+    y[i] = py;
+    vx[i] = pvx;
+    vy[i] = pvy;
+    ax[i] = pax;
+    ay[i] = pay;
+    spawn_x[i] = px;
+    spawn_y[i] = py;
+    grounded[i] = 0.0f;
+    dx[i] = dy[i] = 0.0f;
+    count++;
+    return i;
+}
+
+void entity_store_t::remove(int i) {
+    if (i < 0 || i >= count) throw std::invalid_argument("entity_store_t::remove: index out of range");
+    int last = count - 1;
+    for (std::vector<float> *a : {&x, &y, &vx, &vy, &ax, &ay, &spawn_x, &spawn_y, &grounded, &dx, &dy}) {
+        (*a)[i] = (*a)[last];
+        (*a)[last] = 0.0f;
+    }
+    count--;
+}
+
+// Zaokrąglenie w dół przez konwersję z przesunięciem - w przeciwieństwie do
+// floorf zamienia się na instrukcje wektorowe (poprawne dla v > -65536)
+static inline int32_t batch_floor(float v) {
+    return (int32_t) (v + 65536.0f) - 65536;
+}
+
+// Krok całkowania dla n obiektów (n jest wielokrotnością ENTITY_BATCH).
+// Osobna funkcja z parametrami __restrict - tak kompilator wektoryzuje pętlę.
+static void integrate_arrays(size_t n, float *__restrict px, float *__restrict py,
+                             float *__restrict pvx, float *__restrict pvy,
+                             const float *__restrict pax, const float *__restrict pay,
+                             const float *__restrict pg, float *__restrict pdx, float *__restrict pdy,
+                             int32_t *__restrict psweep, float dt, float reset_y, float hw, float h) {
+    const float half_dt2 = 0.5f * dt * dt;
+    const float eps = 1e-4f;
+
+    // Pętla bez rozgałęzień - obiekty za count to dopełnienie do pełnej paczki
+    for (size_t i = 0; i < n; i++) {
+        // W powietrzu przyspieszenie pionowe zastępuje grawitacja (10)
+        float ay = pay[i] * pg[i] + 10.0f * (1.0f - pg[i]);
+        float ax = pax[i];
+        pdx[i] = pvx[i] * dt + ax * half_dt2;
+        pdy[i] = pvy[i] * dt + ay * half_dt2;
+        pvx[i] = (pvx[i] + ax * dt) * 0.99f;
+        pvy[i] = (pvy[i] + ay * dt) * 0.99f;
+
+        // Czy którakolwiek krawędź prostokąta lub wiersz pod stopami
+        // zmienia kafelek; jeśli nie, ruch jest wolny od kolizji
+        float x0 = px[i], y0 = py[i];
+        float x1 = x0 + pdx[i], y1 = y0 + pdy[i];
+        int32_t crossing = (batch_floor(x0 - hw) != batch_floor(x1 - hw)) |
+                           (batch_floor(x0 + hw - eps) != batch_floor(x1 + hw - eps)) |
+                           (batch_floor(y0 - h) != batch_floor(y1 - h)) |
+                           (batch_floor(y0 - eps) != batch_floor(y1 - eps)) |
+                           (batch_floor(y0 + 0.01f) != batch_floor(y1 + 0.01f)) |
+                           (y1 >= reset_y);
+        psweep[i] = crossing;
+        px[i] = crossing ? x0 : x1;
+        py[i] = crossing ? y0 : y1;
+    }
+}
+
+void integrate_entities(entity_store_t &store, float dt, float reset_y) {
+    integrate_arrays(padded_size((size_t) store.count), store.x.data(), store.y.data(),
+                     store.vx.data(), store.vy.data(), store.ax.data(), store.ay.data(),
+                     store.grounded.data(), store.dx.data(), store.dy.data(), store.needs_sweep.data(),
+                     dt, reset_y, (float) store.box.half_width, (float) store.box.height);
+}
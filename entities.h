@@ -0,0 +1,80 @@
+#ifndef MYGAME_ENTITIES_H
+#define MYGAME_ENTITIES_H
+
+#include "collision.h"
+#include <cstdint>
+#include <vector>
+
+// Szerokość paczki integratora - 8 floatów to jeden rejestr AVX (dwa SSE)
+#define ENTITY_BATCH 8
+
+// Magazyn obiektów gry (przeciwnicy, pociski, cząsteczki) w układzie
+// struktury tablic: każda składowa w osobnej ciągłej tablicy floatów, więc
+// integrator przetwarza po ENTITY_BATCH obiektów naraz. Tablice mają
+// pojemność zaokrągloną w górę do ENTITY_BATCH, a krok nie alokuje pamięci.
+struct entity_store_t {
+    aabb_t box = {0.4, 0.9}; // prostokąt kolizji wspólny dla wszystkich obiektów
+    int count = 0;
+
+    std::vector<float> x, y;        // pozycja (środek dolnej krawędzi)
+    std::vector<float> vx, vy;      // prędkość
+    std::vector<float> ax, ay;      // przyspieszenie
+    std::vector<float> spawn_x, spawn_y; // pozycja po spadnięciu poniżej mapy
+    std::vector<float> grounded;    // 1 - stoi na ziemi, 0 - w powietrzu
+    std::vector<float> dx, dy;      // przesunięcie w bieżącym kroku (bufor roboczy)
+    std::vector<int32_t> needs_sweep; // 1 - ruch przecina granicę kafelka (bufor roboczy)
+
+    void reserve(int capacity);
+
+    // Dodaje obiekt i zwraca jego indeks. Nowy obiekt zaczyna w powietrzu.
+    int add(float px, float py, float pvx = 0, float pvy = 0, float pax = 0, float pay = 0);
+
+    // Usuwa obiekt, przenosząc na jego miejsce ostatni (indeksy się zmieniają).
+    // Rzuca std::invalid_argument, gdy i nie jest w 0..count-1.
+    void remove(int i);
+
+private:
+    void resize_arrays(size_t size);
+};
+
+// Część wektorowa kroku: wylicza dx, dy oraz nowe vx, vy. Obiekt, którego
+// prostokąt nie przecina w tym kroku żadnej granicy kafelka (ani wiersza pod
+// stopami), nie może zderzyć się z mapą ani zmienić stanu podłoża - jest
+// przesuwany od razu. Pozostałe mają needs_sweep = 1.
+void integrate_entities(entity_store_t &store, float dt, float reset_y);
+
+// Krok fizyki dla wszystkich obiektów, z tymi samymi regułami co
+// update_player: grawitacja 10 w powietrzu, tarcie 0.99 na krok, kolizja
+// sweep_aabb z kafelkami i powrót na start po spadnięciu poniżej mapy.
+// Całkowanie idzie paczkami po ENTITY_BATCH obiektów, kolizja obiekt po obiekcie.
+template<class map_t>
+void step_entities(entity_store_t &store, const map_t &map, float dt) {
+    const double eps = 1e-9;
+    const float reset_y = (float) (map.height - 0.5);
+    integrate_entities(store, dt, reset_y);
+
+    for (int i = 0; i < store.count; i++) {
+        if (!store.needs_sweep[i]) continue;
+        sweep_result_t sweep = sweep_aabb(map, store.box, store.x[i], store.y[i], store.dx[i], store.dy[i]);
+        float nx = (float) sweep.x;
+        float ny = (float) sweep.y;
+        if (sweep.normal_x != 0) store.vx[i] = 0;
+        if (sweep.normal_y != 0) store.vy[i] = 0;
+        if (ny >= reset_y) {
+            nx = store.spawn_x[i];
+            ny = store.spawn_y[i];
+            store.vx[i] = 0;
+            store.vy[i] = 0;
+        }
+        store.x[i] = nx;
+        store.y[i] = ny;
+
+        // Stan podłoża dla następnego kroku (jak is_on_the_ground)
+        int row = floor_to_int(ny + 0.01);
+        int col0 = floor_to_int(nx - store.box.half_width);
+        int col1 = floor_to_int(nx + store.box.half_width - eps);
+        store.grounded[i] = solid_in_span(map, col0, col1, row) ? 1.0f : 0.0f;
+    }
+}
+
+#endif
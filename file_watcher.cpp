@@ -0,0 +1,109 @@
+#include "file_watcher.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+file_watcher_t::file_watcher_t(const std::vector<std::string> &dirs) {
+#ifdef __linux__
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd < 0) throw std::runtime_error(std::string("Couldn't start file watcher: ") + std::strerror(errno));
+    if (pipe(wake_fds) < 0) {
+        std::string error = std::strerror(errno);
+        close_fds();
+        throw std::runtime_error("Couldn't start file watcher: " + error);
+    }
+    for (const std::string &dir : dirs) {
+        int wd = inotify_add_watch(inotify_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0) {
+            std::string error = std::strerror(errno);
+            close_fds();
+            throw std::runtime_error("Couldn't watch directory " + dir + ": " + error);
+        }
+        watches.emplace_back(wd, dir);
+    }
+    watcher = std::thread(&file_watcher_t::watch_loop, this);
+#else
+    (void) dirs;
+#endif
+}
+
+file_watcher_t::~file_watcher_t() {
+#ifdef __linux__
+    if (watcher.joinable()) {
+        char byte = 0;
+        while (write(wake_fds[1], &byte, 1) < 0 && errno == EINTR) {}
+        watcher.join();
+    }
+#endif
+    close_fds();
+}
+
+void file_watcher_t::close_fds() {
+#ifdef __linux__
+    for (int fd : {inotify_fd, wake_fds[0], wake_fds[1]}) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+    inotify_fd = wake_fds[0] = wake_fds[1] = -1;
+}
+
+bool file_watcher_t::poll(std::vector<std::string> &changed) {
+    if (!has_pending.load(std::memory_order_acquire)) return false;
+    std::lock_guard<std::mutex> lock(mutex);
+    changed.clear();
+    changed.swap(pending);
+    has_pending.store(false, std::memory_order_relaxed);
+    return !changed.empty();
+}
+
+void file_watcher_t::publish(std::vector<std::string> &batch) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::string &path : batch) {
+            if (std::find(pending.begin(), pending.end(), path) == pending.end()) pending.push_back(std::move(path));
+        }
+        has_pending.store(true, std::memory_order_release);
+    }
+    batch.clear();
+}
+
+void file_watcher_t::watch_loop() {
+#ifdef __linux__
+    std::vector<std::string> batch;
+    alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+        // Zmiany są zbierane, dopóki nie minie FILE_WATCHER_SETTLE_MS bez zdarzeń
+        struct pollfd fds[2] = {{inotify_fd, POLLIN, 0}, {wake_fds[0], POLLIN, 0}};
+        int ready = ::poll(fds, 2, batch.empty() ? -1 : FILE_WATCHER_SETTLE_MS);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (fds[1].revents) return;
+        if (ready == 0) {
+            publish(batch);
+            continue;
+        }
+
+        ssize_t length = read(inotify_fd, buffer, sizeof(buffer));
+        if (length <= 0) continue;
+        for (char *p = buffer; p < buffer + length;) {
+            const struct inotify_event *event = (const struct inotify_event *) p;
+            p += sizeof(struct inotify_event) + event->len;
+            if (!event->len || !(event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))) continue;
+            for (const std::pair<int, std::string> &watch : watches) {
+                if (watch.first != event->wd) continue;
+                std::string path = watch.second + "/" + event->name;
+                if (std::find(batch.begin(), batch.end(), path) == batch.end()) batch.push_back(path);
+            }
+        }
+    }
+#endif
+}
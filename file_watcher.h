@@ -0,0 +1,49 @@
+#ifndef MYGAME_FILE_WATCHER_H
+#define MYGAME_FILE_WATCHER_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Czas ciszy po ostatnim zdarzeniu, po którym zmiany są oddawane do poll() -
+// edytor zapisujący plik kilka razy pod rząd daje jedno przeładowanie
+#define FILE_WATCHER_SETTLE_MS 50
+
+// Obserwator plików w katalogach (bez podkatalogów) oparty na inotify.
+// Wątek obserwatora zbiera ścieżki dir/nazwa plików zapisanych i zamkniętych
+// (IN_CLOSE_WRITE) albo podmienionych przez rename (IN_MOVED_TO - tak
+// zapisuje write_level_file), bez powtórzeń. poll() zabiera je w wątku gry.
+// Poza Linuksem obserwator niczego nie zgłasza (supported() == false).
+class file_watcher_t {
+public:
+    // Rzuca std::runtime_error, gdy nie da się obserwować któregoś katalogu
+    explicit file_watcher_t(const std::vector<std::string> &dirs);
+    ~file_watcher_t();
+
+    file_watcher_t(const file_watcher_t &) = delete;
+    file_watcher_t &operator=(const file_watcher_t &) = delete;
+
+    bool supported() const { return inotify_fd >= 0; }
+
+    // Zastępuje zawartość changed plikami zmienionymi od poprzedniego
+    // wywołania; false (bez blokady i alokacji), gdy nic się nie zmieniło
+    bool poll(std::vector<std::string> &changed);
+
+private:
+    void watch_loop();
+    void publish(std::vector<std::string> &batch);
+    void close_fds();
+
+    int inotify_fd = -1;
+    int wake_fds[2] = {-1, -1}; // potok budzący wątek przy zamykaniu
+    std::vector<std::pair<int, std::string>> watches; // deskryptor obserwacji -> katalog
+    std::thread watcher;
+
+    std::mutex mutex;
+    std::vector<std::string> pending; // zmienione pliki czekające na poll()
+    std::atomic<bool> has_pending{false};
+};
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef MYGAME_GAME_H
+#define MYGAME_GAME_H
+
+#include "collision.h"
+#include <cmath>
+#include <vector>
+
+#define TILE_SIZE 64
+
+// Struktura przechowująca mapę gry
+struct game_map_t {
+    int width, height;
+    std::vector<int> map;
+
+    int get(int x, int y) const {
+        if (x < 0) return 1;
+        if (x >= width) return 1;
+        if (y < 0) return 1;
+        if (y >= height) return 1;
+        return map[y * width + x];
+    }
+};
+
+// Mapy gry wkompilowane w program (poziomy 1-3)
+extern game_map_t game_map1;
+extern game_map_t game_map2;
+extern game_map_t game_map3;
+extern std::vector<game_map_t*> game_maps;
+extern int current_map_index;
+
+// Struktura przechowująca wektor dwuwymiarowy
+union vect_t {
+    struct {
+        double x;
+        double y;
+    } v;
+    double p[2];
+};
+
+// Przeciążenie operatora + dla wektora
+inline vect_t operator+(const vect_t a, const vect_t b) {
+    vect_t ret = a;
+    ret.v.x += b.v.x;
+    ret.v.y += b.v.y;
+    return ret;
+}
+
+// Przeciążenie operatora * dla wektora i liczby
+inline vect_t operator*(const vect_t a, const double b) {
+    vect_t ret = a;
+    ret.v.x *= b;
+    ret.v.y *= b;
+    return ret;
+}
+
+// Struktura przechowująca informacje o graczu
+struct player_t {
+    vect_t p; // pozycja
+    vect_t v; // prędkość
+    vect_t a; // przyspieszenie
+};
+
+// Funkcja resetująca gracza na początek mapy
+void reset_player(player_t &player);
+
+// Fizyka działa na dowolnej mapie z polami width, height i metodą get(x, y)
+// zwracającą 1 poza mapą (game_map_t, chunked_map_t).
+
+// Funkcja sprawdzająca, czy dany punkt jest w kolizji z mapą gry
+template<class map_t>
+bool is_in_collision(vect_t pos, const map_t &map) {
+    return map.get((int) pos.v.x, (int) pos.v.y) > 0;
+}
+
+// Prostokąt kolizji gracza (szerokość jak dawne punkty kolizji -0.4..0.4)
+const aabb_t player_box = {0.4, 0.9};
+
+// Funkcja sprawdzająca, czy gracz stoi na ziemi (jest na podłożu):
+// pełny kafelek tuż pod całą szerokością prostokąta kolizji
+template<class map_t>
+bool is_on_the_ground(player_t player, const map_t &map) {
+    int row = floor_to_int(player.p.v.y + 0.01);
+    int col0 = floor_to_int(player.p.v.x - player_box.half_width);
+    int col1 = floor_to_int(player.p.v.x + player_box.half_width - 1e-9);
+    return solid_in_span(map, col0, col1, row);
+}
+
+// Funkcja aktualizująca stan gracza na podstawie fizyki gry
+template<class map_t>
+player_t update_player(player_t player_old, const map_t &map, double dt) {
+    player_t player = player_old;
+
+    // Ustawienie przyspieszenia ziemskiego, jeśli gracz nie stoi na ziemi
+    if (!is_on_the_ground(player_old, map)) {
+        player_old.a.v.y = 10; // przyspieszenie ziemskie (w powietrzu)
+    }
+
+    // Obliczenie przesunięcia gracza
+    vect_t delta = (player_old.v * dt) + (player_old.a * dt * dt) * 0.5;
+    // Obliczenie nowej prędkości gracza
+    player.v = player_old.v + (player_old.a * dt);
+    player.v = player.v * 0.99; // Zmniejszenie prędkości w wyniku tarcia
+
+    // Obsługa kolizji z blokami: przesunięcie prostokąta gracza po siatce
+    // kafelków, osobno w osi x i y; kontakt zatrzymuje prędkość w danej osi
+    sweep_result_t sweep = sweep_aabb(map, player_box, player_old.p.v.x, player_old.p.v.y, delta.v.x, delta.v.y);
+    player.p.v.x = sweep.x;
+    player.p.v.y = sweep.y;
+    if (sweep.normal_x != 0) player.v.v.x = 0;
+    if (sweep.normal_y != 0) player.v.v.y = 0;
+
+    // Jeśli gracz spadnie poniżej mapy, zresetuj jego pozycję
+    if (player.p.v.y >= map.height - 0.5) {
+        reset_player(player);
+    }
+
+    return player;
+}
+
+// Klawisze sterujące graczem (zapisywane w logu wejścia, input_log.h)
+enum input_key_t {
+    INPUT_KEY_UP = 0,
+    INPUT_KEY_LEFT = 1,
+    INPUT_KEY_RIGHT = 2,
+    INPUT_KEY_RESET = 3,
+};
+
+// Reguły sterowania z obsługi SDL_KEYDOWN/SDL_KEYUP: wciśnięcie działa tylko
+// na ziemi, puszczenie zeruje przyspieszenie, puszczenie R resetuje gracza.
+// Zwraca true, gdy wciśnięcie zostało przyjęte (gracz stał na ziemi).
+template<class map_t>
+bool apply_input(player_t &player, const map_t &map, input_key_t key, bool pressed) {
+    if (pressed) {
+        if (!is_on_the_ground(player, map)) return false;
+        if (key == INPUT_KEY_UP) player.a.v.y = -500;
+        if (key == INPUT_KEY_LEFT) player.a.v.x = -2;
+        if (key == INPUT_KEY_RIGHT) player.a.v.x = 2;
+        return true;
+    }
+    if (key == INPUT_KEY_RESET) reset_player(player);
+    if (key == INPUT_KEY_UP) player.a.v.y = 0;
+    if (key == INPUT_KEY_LEFT || key == INPUT_KEY_RIGHT) player.a.v.x = 0;
+    return false;
+}
+
+// Przejście między mapami wkompilowanymi (game_maps, current_map_index), gdy
+// gracz wyjdzie poza lewą lub prawą krawędź - level_transition poniżej.
+// Zwraca mapę, na której gracz jest po przejściu.
+game_map_t *update_map_transition(player_t &player);
+
+// To samo przejście dla listy poziomów dowolnego typu (np. std::vector
+// wskaźników na mapy albo level_manager_t): levels.size() i levels[i]->width.
+// Zwraca indeks poziomu, na którym gracz jest po przejściu.
+template<class levels_t>
+int level_transition(player_t &player, levels_t &levels, int index) {
+    if (player.p.v.x >= levels[index]->width) {
+        index++;
+        if (index >= (int) levels.size()) {
+            index = 0;
+        }
+        reset_player(player);
+    } else if (player.p.v.x < 0 && index > 0) {
+        // Gracz wraca na drugi od końca kafelek poprzedniego poziomu
+        index--;
+        player.p.v.x = levels[index]->width - 2;
+        player.p.v.y = 1;
+        player.v.v.x = 0;
+        player.v.v.y = 0;
+    } else if (player.p.v.x < 0) {
+        reset_player(player);
+    }
+    return index;
+}
+
+#endif
@@ -0,0 +1,62 @@
+#include "input.h"
+
+bool input_key_from_scancode(SDL_Scancode scancode, input_key_t &key) {
+    switch (scancode) {
+        case SDL_SCANCODE_UP:
+            key = INPUT_KEY_UP;
+            return true;
+        case SDL_SCANCODE_LEFT:
+            key = INPUT_KEY_LEFT;
+            return true;
+        case SDL_SCANCODE_RIGHT:
+            key = INPUT_KEY_RIGHT;
+            return true;
+        case SDL_SCANCODE_R:
+            key = INPUT_KEY_RESET;
+            return true;
+        default:
+            return false;
+    }
+}
+
+SDL_Scancode input_key_scancode(input_key_t key) {
+    static const SDL_Scancode scancodes[INPUT_KEY_COUNT] = {SDL_SCANCODE_UP, SDL_SCANCODE_LEFT, SDL_SCANCODE_RIGHT,
+                                                            SDL_SCANCODE_R};
+    return scancodes[key];
+}
+
+bool input_sampler_t::handle_event(const SDL_KeyboardEvent &event) {
+    input_key_t key;
+    if (!input_key_from_scancode(event.keysym.scancode, key)) return false;
+    // Trzymany klawisz jest powtarzany w begin_tick, powtórzenia systemowe są zbędne
+    if (event.repeat) return true;
+
+    unsigned head = queue_head.load(std::memory_order_relaxed);
+    if (head - queue_tail.load(std::memory_order_acquire) >= INPUT_QUEUE_SIZE) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    // Znacznik czasu zdarzenia ma 32 bity; przeniesienie na zegar 64-bitowy
+    Uint64 now = SDL_GetTicks64();
+    double timestamp = (double) (now - (Uint32) ((Uint32) now - event.timestamp));
+    queue[head % INPUT_QUEUE_SIZE] = {key, event.type == SDL_KEYDOWN, timestamp};
+    queue_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void input_sampler_t::sample_keyboard() {
+    const Uint8 *state = SDL_GetKeyboardState(NULL);
+    unsigned mask = 0;
+    for (int k = 0; k < INPUT_KEY_COUNT; k++) {
+        if (state[input_key_scancode((input_key_t) k)]) mask |= 1u << k;
+    }
+    held_mask.store(mask, std::memory_order_release);
+}
+
+void input_sampler_t::measure(double timestamp, double now) {
+    double ms = now - timestamp;
+    if (ms < 0) ms = 0;
+    latency.count++;
+    latency.total_ms += ms;
+    if (ms > latency.max_ms) latency.max_ms = ms;
+}
@@ -0,0 +1,133 @@
+#ifndef MYGAME_INPUT_H
+#define MYGAME_INPUT_H
+
+#include "SDL2/SDL.h"
+#include "game.h"
+#include <atomic>
+
+#define INPUT_KEY_COUNT 4
+
+// Klawisz sterujący gracza odpowiadający klawiszowi SDL; false dla pozostałych
+bool input_key_from_scancode(SDL_Scancode scancode, input_key_t &key);
+
+SDL_Scancode input_key_scancode(input_key_t key);
+
+// Opóźnienie od zdarzenia klawiatury do kroku fizyki, w którym zostało
+// zastosowane (czas rzeczywisty, ms)
+struct input_latency_t {
+    long long count = 0;
+    double total_ms = 0;
+    double max_ms = 0;
+
+    double mean_ms() const { return count ? total_ms / count : 0.0; }
+};
+
+// Wejście próbkowane na początku każdego kroku fizyki zamiast raz na klatkę.
+//
+// Zdarzenia SDL_KEYDOWN/SDL_KEYUP są zapisywane jako krawędzie ze znacznikiem
+// czasu zdarzenia i stosowane przed krokiem, w którego przedziale czasu
+// wypadają - nie wszystkie naraz przed pierwszym krokiem klatki. Klawisz
+// ruchu, który jest trzymany (według SDL_GetKeyboardState), a którego
+// wciśnięcie gra odrzuciła (gracz był w powietrzu), jest wciskany ponownie
+// w kolejnych krokach, więc nie przepada do powtórzenia klawisza.
+//
+// Zdarzenia odbiera wątek okna (handle_event, sample_keyboard), a kroki
+// fizyki wykonuje wątek symulacji (begin_tick). Krawędzie przechodzą przez
+// kolejkę bez blokad dla jednego producenta i jednego konsumenta; krawędź
+// z przyszłego kroku czeka w kolejce.
+//
+// Wątek okna odbiera zdarzenia tylko między klatkami (SDL wymaga tego
+// w wątku okna), a z synchronizacją pionową SDL_RenderPresent blokuje go
+// do ~1/60 s. Krawędź dociera więc do wątku symulacji z opóźnieniem do
+// jednej klatki i trafia do pierwszego kroku po odebraniu, nie do kroku,
+// w którego czasie nastąpiła. main2 zmniejsza to, odbierając zdarzenia
+// także tuż przed SDL_RenderPresent; zmierzone opóźnienie (latency)
+// program wypisuje przy wyjściu.
+#define INPUT_QUEUE_SIZE 256
+
+class input_sampler_t {
+public:
+    // Wątek okna: zdarzenie klawiatury z pętli zdarzeń. Zwraca false dla
+    // klawiszy, które nie sterują graczem (obsługuje je wywołujący).
+    bool handle_event(const SDL_KeyboardEvent &event);
+
+    // Wątek okna: zapisuje stan klawiatury (SDL_GetKeyboardState) po
+    // opróżnieniu kolejki zdarzeń SDL
+    void sample_keyboard();
+
+    // Wątek symulacji: początek kroku fizyki, który kończy się w chwili
+    // tick_end (ms zegara SDL_GetTicks64). Wywołuje apply(key, pressed) dla
+    // krawędzi z czasem <= tick_end i dla trzymanych klawiszy; apply zwraca
+    // true, gdy gra przyjęła wciśnięcie.
+    template<class fn_t>
+    void begin_tick(double tick_end, fn_t apply);
+
+    // Wątek symulacji: po przywróceniu zapisanego stanu gry (cofanie czasu)
+    // przyspieszenie gracza pochodzi z chwili zapisu, a nie z klawiszy
+    // trzymanych teraz - puszczenie klawisza trzymanego wtedy nigdy by nie
+    // przyszło. Wywołujący zeruje przyspieszenie, a resync wciska ponownie
+    // trzymane klawisze ruchu przez apply(key, true); odrzucone wciśnięcia
+    // (gracz w powietrzu) są powtarzane w begin_tick jak zwykle.
+    template<class fn_t>
+    void resync(fn_t apply);
+
+    input_latency_t latency; // wątek symulacji
+    std::atomic<long long> dropped{0}; // krawędzie odrzucone przy pełnej kolejce
+
+private:
+    struct edge_t {
+        input_key_t key;
+        bool pressed;
+        double timestamp; // ms zegara SDL_GetTicks64
+    };
+
+    // Kolejka z wątku okna do wątku symulacji
+    edge_t queue[INPUT_QUEUE_SIZE];
+    alignas(64) std::atomic<unsigned> queue_head{0}; // zapisuje wątek okna
+    alignas(64) std::atomic<unsigned> queue_tail{0}; // zapisuje wątek symulacji
+    std::atomic<unsigned> held_mask{0};              // bit klawisza - trzymany
+
+    // Stan wątku symulacji
+    bool down[INPUT_KEY_COUNT] = {};     // stan klawisza przekazany grze
+    bool accepted[INPUT_KEY_COUNT] = {}; // gra przyjęła ostatnie wciśnięcie
+
+    void measure(double timestamp, double now);
+};
+
+template<class fn_t>
+void input_sampler_t::begin_tick(double tick_end, fn_t apply) {
+    // Najpierw stan klawiatury, potem kolejka: wątek okna wstawia krawędzie
+    // przed zapisem stanu, więc każda zmiana widoczna w held ma już krawędź
+    const unsigned held = held_mask.load(std::memory_order_acquire);
+    const unsigned head = queue_head.load(std::memory_order_acquire);
+    unsigned tail = queue_tail.load(std::memory_order_relaxed);
+
+    // Krawędzie z późniejszych kroków zostają w kolejce (bez kopiowania i alokacji)
+    const double now = (double) SDL_GetTicks64();
+    for (; tail != head && queue[tail % INPUT_QUEUE_SIZE].timestamp <= tick_end; tail++) {
+        const edge_t &edge = queue[tail % INPUT_QUEUE_SIZE];
+        down[edge.key] = edge.pressed;
+        bool ok = apply(edge.key, edge.pressed);
+        accepted[edge.key] = edge.pressed && ok;
+        measure(edge.timestamp, now);
+    }
+    bool queued[INPUT_KEY_COUNT] = {}; // krawędzie z późniejszych kroków mają pierwszeństwo przed próbką
+    for (unsigned i = tail; i != head; i++) queued[queue[i % INPUT_QUEUE_SIZE].key] = true;
+    queue_tail.store(tail, std::memory_order_release);
+
+    // Trzymany klawisz ruchu, którego wciśnięcie gra odrzuciła; reset działa
+    // przy puszczeniu, więc nie jest powtarzany
+    for (int k = INPUT_KEY_UP; k <= INPUT_KEY_RIGHT; k++) {
+        if (queued[k] || !down[k] || accepted[k] || !(held & (1u << k))) continue;
+        accepted[k] = apply((input_key_t) k, true);
+    }
+}
+
+template<class fn_t>
+void input_sampler_t::resync(fn_t apply) {
+    for (int k = INPUT_KEY_LEFT; k <= INPUT_KEY_RIGHT; k++) {
+        accepted[k] = down[k] && apply((input_key_t) k, true);
+    }
+}
+
+#endif
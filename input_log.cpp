@@ -0,0 +1,92 @@
+#include "input_log.h"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+input_recorder_t::input_recorder_t(const char *path, double tick_rate) {
+    file = std::fopen(path, "wb");
+    if (!file) throw std::runtime_error(std::string("Couldn't create input log: ") + path);
+    input_log_header_t header = {};
+    std::memcpy(header.magic, INPUT_LOG_MAGIC, 4);
+    header.version = INPUT_LOG_VERSION;
+    header.tick_rate = tick_rate;
+    std::fwrite(&header, sizeof(header), 1, file);
+}
+
+input_recorder_t::~input_recorder_t() {
+    if (file) std::fclose(file);
+}
+
+void input_recorder_t::write_varint(uint64_t value) {
+    while (value >= 0x80) {
+        std::fputc((int) (value & 0x7f) | 0x80, file);
+        value >>= 7;
+    }
+    std::fputc((int) value, file);
+}
+
+void input_recorder_t::record(long long tick, input_key_t key, bool pressed) {
+    if (!file) return;
+    write_varint((uint64_t) (tick - last_tick));
+    std::fputc(((int) key << 1) | (pressed ? 1 : 0), file);
+    last_tick = tick;
+}
+
+void input_recorder_t::finish(long long ticks, uint64_t checksum) {
+    if (!file) return;
+    write_varint((uint64_t) (ticks - last_tick));
+    std::fputc(INPUT_LOG_END, file);
+    std::fwrite(&checksum, sizeof(checksum), 1, file);
+    std::fclose(file);
+    file = nullptr;
+}
+
+input_log_t read_input_log(const char *path) {
+    FILE *file = std::fopen(path, "rb");
+    if (!file) throw std::runtime_error(std::string("Couldn't open input log: ") + path);
+    std::vector<unsigned char> data;
+    unsigned char buffer[4096];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) data.insert(data.end(), buffer, buffer + n);
+    std::fclose(file);
+
+    input_log_header_t header;
+    if (data.size() < sizeof(header)) throw std::runtime_error(std::string("Input log too small: ") + path);
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, INPUT_LOG_MAGIC, 4) != 0 || header.version != INPUT_LOG_VERSION ||
+        !(header.tick_rate > 0)) {
+        throw std::runtime_error(std::string("Invalid input log: ") + path);
+    }
+
+    input_log_t log;
+    log.tick_rate = header.tick_rate;
+    size_t pos = sizeof(header);
+    long long tick = 0;
+    while (pos < data.size()) {
+        uint64_t delta = 0;
+        int shift = 0;
+        while (pos < data.size() && (data[pos] & 0x80)) {
+            if (shift > 56) throw std::runtime_error(std::string("Invalid input log record: ") + path);
+            delta |= (uint64_t) (data[pos++] & 0x7f) << shift;
+            shift += 7;
+        }
+        if (pos + 1 >= data.size()) break; // urwany rekord
+        delta |= (uint64_t) data[pos++] << shift;
+        unsigned char code = data[pos++];
+        tick += (long long) delta;
+
+        if (code == INPUT_LOG_END) {
+            if (pos + sizeof(log.checksum) > data.size()) break;
+            std::memcpy(&log.checksum, data.data() + pos, sizeof(log.checksum));
+            log.ticks = tick;
+            log.complete = true;
+            return log;
+        }
+        if ((code >> 1) > INPUT_KEY_RESET) throw std::runtime_error(std::string("Invalid input log record: ") + path);
+        log.events.push_back({tick, (input_key_t) (code >> 1), (code & 1) != 0});
+    }
+
+    // Log bez zakończenia: odtwarzamy do ostatniego zapisanego zdarzenia
+    log.ticks = log.events.empty() ? 0 : log.events.back().tick + 1;
+    return log;
+}
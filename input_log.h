@@ -0,0 +1,79 @@
+#ifndef MYGAME_INPUT_LOG_H
+#define MYGAME_INPUT_LOG_H
+
+#include "determinism.h"
+#include "game.h"
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Binarny log wejścia (*.sgdi), liczby little-endian:
+//
+//   input_log_header_t
+//   rekordy: varint (liczba kroków od poprzedniego rekordu), bajt kodu
+//            kod = klawisz << 1 | wciśnięty; INPUT_LOG_END kończy log
+//   po INPUT_LOG_END: uint64_t suma kontrolna trajektorii gracza
+//
+// Zdarzenie z krokiem t jest stosowane przed wykonaniem kroku fizyki t, więc
+// log z tą samą częstotliwością kroków odtwarza dokładnie te same stany gracza.
+#define INPUT_LOG_MAGIC "SGDI"
+#define INPUT_LOG_VERSION 1
+#define INPUT_LOG_END 0xff
+
+struct input_log_header_t {
+    char magic[4];
+    uint32_t version;
+    double tick_rate; // częstotliwość kroków fizyki nagrania (Hz)
+};
+
+static_assert(sizeof(input_log_header_t) == 16, "input_log_header_t layout");
+
+struct input_event_t {
+    long long tick;
+    input_key_t key;
+    bool pressed;
+};
+
+// Odczytany log
+struct input_log_t {
+    double tick_rate = 60.0;
+    std::vector<input_event_t> events;
+    long long ticks = 0;   // liczba kroków nagrania
+    uint64_t checksum = 0; // suma kontrolna trajektorii z nagrania
+    bool complete = false; // false - log urwany (np. gra przerwana), bez sumy kontrolnej
+};
+
+// Suma kontrolna FNV-1a trajektorii: uaktualniana stanem gracza po każdym kroku
+inline uint64_t trajectory_hash(uint64_t hash, const player_t &player) {
+    return fnv1a(hash, &player, sizeof(player));
+}
+
+const uint64_t TRAJECTORY_HASH_START = FNV1A_START;
+
+// Zapis logu w trakcie gry. Rekordy trafiają do bufora pliku na bieżąco,
+// więc log przerwanej gry też da się odtworzyć (bez sprawdzenia sumy).
+class input_recorder_t {
+public:
+    // Rzuca std::runtime_error, gdy pliku nie da się utworzyć
+    input_recorder_t(const char *path, double tick_rate);
+    ~input_recorder_t();
+
+    input_recorder_t(const input_recorder_t &) = delete;
+    input_recorder_t &operator=(const input_recorder_t &) = delete;
+
+    void record(long long tick, input_key_t key, bool pressed);
+
+    // Zamyka log: liczba wykonanych kroków i suma kontrolna trajektorii
+    void finish(long long ticks, uint64_t checksum);
+
+private:
+    void write_varint(uint64_t value);
+
+    FILE *file;
+    long long last_tick = 0;
+};
+
+// Wczytuje cały log; rzuca std::runtime_error przy błędnym pliku
+input_log_t read_input_log(const char *path);
+
+#endif
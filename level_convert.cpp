@@ -0,0 +1,38 @@
+// Konwerter wkompilowanych map (game_map1..3) do plików poziomów *.sgdl.
+// Użycie: level_convert [katalog_wyjściowy]  (domyślnie "levels")
+#include "game.h"
+#include "level_file.h"
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+int main(int argc, char *argv[]) {
+    std::string out_dir = argc > 1 ? argv[1] : "levels";
+
+    for (size_t i = 0; i < game_maps.size(); i++) {
+        const game_map_t &map = *game_maps[i];
+        std::string path = out_dir + "/level" + std::to_string(i + 1) + ".sgdl";
+        if (!write_level_file(path.c_str(), map)) {
+            std::fprintf(stderr, "Couldn't write level file: %s\n", path.c_str());
+            return 1;
+        }
+
+        // Kontrola: plik wczytany z powrotem musi dawać te same kafelki
+        try {
+            mapped_level_t level(path.c_str());
+            for (int y = -1; y <= map.height; y++) {
+                for (int x = -1; x <= map.width; x++) {
+                    if (level.get(x, y) != map.get(x, y) || level.solid(x, y) != (map.get(x, y) > 0)) {
+                        std::fprintf(stderr, "Level file %s differs at %d,%d\n", path.c_str(), x, y);
+                        return 1;
+                    }
+                }
+            }
+            std::printf("%s: %dx%d, %zu bytes\n", path.c_str(), level.width, level.height, level.size());
+        } catch (const std::exception &e) {
+            std::fprintf(stderr, "%s\n", e.what());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,207 @@
+#include "level_file.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static uint32_t align8(uint32_t offset) {
+    return (offset + 7u) & ~7u;
+}
+
+// Czyta cały plik do nowej tablicy (size - rozmiar w bajtach); nullptr przy błędzie
+static uint64_t *read_whole_file(const char *path, size_t &size) {
+    std::FILE *file = std::fopen(path, "rb");
+    if (!file) return nullptr;
+    uint64_t *data = nullptr;
+    if (std::fseek(file, 0, SEEK_END) == 0) {
+        long length = std::ftell(file);
+        if (length >= 0 && std::fseek(file, 0, SEEK_SET) == 0) {
+            size = (size_t) length;
+            data = new uint64_t[(size + 7) / 8 + 1];
+            if (std::fread(data, 1, size, file) != size) {
+                delete[] data;
+                data = nullptr;
+            }
+        }
+    }
+    std::fclose(file);
+    return data;
+}
+
+mapped_level_t::mapped_level_t(const char *path, bool copy) : width(0), height(0) {
+    if (copy) {
+        inode = level_file_id(path);
+        owned = read_whole_file(path, mapping_size);
+        if (!owned) throw std::runtime_error(std::string("Couldn't read level file: ") + path);
+        mapping = owned;
+    } else {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) throw std::runtime_error(std::string("Couldn't open level file: ") + path);
+        LARGE_INTEGER file_size;
+        GetFileSizeEx(file, &file_size);
+        HANDLE map_handle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!map_handle) {
+            CloseHandle(file);
+            throw std::runtime_error(std::string("Couldn't map level file: ") + path);
+        }
+        mapping = MapViewOfFile(map_handle, FILE_MAP_READ, 0, 0, 0);
+        if (!mapping) {
+            CloseHandle(map_handle);
+            CloseHandle(file);
+            throw std::runtime_error(std::string("Couldn't map level file: ") + path);
+        }
+        file_handle = file;
+        mapping_handle = map_handle;
+        mapping_size = (size_t) file_size.QuadPart;
+#else
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) throw std::runtime_error(std::string("Couldn't open level file: ") + path);
+        struct stat st;
+        if (fstat(fd, &st) < 0 || st.st_size < (off_t) sizeof(level_file_header_t)) {
+            close(fd);
+            throw std::runtime_error(std::string("Level file too small: ") + path);
+        }
+        mapping_size = (size_t) st.st_size;
+        inode = (uint64_t) st.st_ino;
+        mapping = mmap(NULL, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // mapowanie pozostaje ważne po zamknięciu deskryptora
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+            throw std::runtime_error(std::string("Couldn't map level file: ") + path);
+        }
+#endif
+    }
+
+    // Walidacja nagłówka i granic sekcji - mapowany plik jest czytany bez kopiowania
+    const level_file_header_t *header = (const level_file_header_t *) mapping;
+    const char *error = nullptr;
+    if (mapping_size < sizeof(level_file_header_t) || std::memcmp(header->magic, LEVEL_FILE_MAGIC, 4) != 0) {
+        error = "bad magic";
+    } else if (header->version != LEVEL_FILE_VERSION) {
+        error = "unsupported version";
+    } else if (header->width == 0 || header->height == 0 || header->width > 0x7fffffff / header->height ||
+               header->palette_count == 0 || header->file_size != mapping_size ||
+               header->collision_words != (header->width + 63) / 64) {
+        error = "bad dimensions";
+    } else if ((header->palette_offset | header->tiles_offset | header->collision_offset) & 7u) {
+        error = "misaligned section";
+    } else if ((uint64_t) header->palette_offset + (uint64_t) header->palette_count * sizeof(level_palette_entry_t) > mapping_size ||
+               (uint64_t) header->tiles_offset + (uint64_t) header->width * header->height > mapping_size ||
+               (uint64_t) header->collision_offset + (uint64_t) header->collision_words * header->height * 8 > mapping_size) {
+        error = "section out of range";
+    }
+    if (error) {
+        unmap();
+        throw std::runtime_error(std::string("Invalid level file ") + path + ": " + error);
+    }
+
+    const unsigned char *base = (const unsigned char *) mapping;
+    width = (int) header->width;
+    height = (int) header->height;
+    palette = (const level_palette_entry_t *) (base + header->palette_offset);
+    palette_count = header->palette_count;
+    tiles = base + header->tiles_offset;
+    collision = (const uint64_t *) (base + header->collision_offset);
+    collision_words = (int) header->collision_words;
+}
+
+mapped_level_t::~mapped_level_t() {
+    unmap();
+}
+
+void mapped_level_t::unmap() {
+    if (owned) {
+        delete[] owned;
+        owned = nullptr;
+        mapping = nullptr;
+        return;
+    }
+#ifdef _WIN32
+    if (mapping) UnmapViewOfFile(mapping);
+    if (mapping_handle) CloseHandle((HANDLE) mapping_handle);
+    if (file_handle) CloseHandle((HANDLE) file_handle);
+    mapping_handle = file_handle = nullptr;
+#else
+    if (mapping) munmap(mapping, mapping_size);
+#endif
+    mapping = nullptr;
+}
+
+uint64_t level_file_id(const char *path) {
+#ifdef _WIN32
+    (void) path;
+    return 0;
+#else
+    struct stat st;
+    if (stat(path, &st) < 0) return 0;
+    return (uint64_t) st.st_ino;
+#endif
+}
+
+bool write_level_file(const char *path, const game_map_t &map) {
+    if (map.width <= 0 || map.height <= 0 || (int) map.map.size() != map.width * map.height) return false;
+
+    int max_tile = 0;
+    for (int tile : map.map) {
+        if (tile < 0 || tile > 255) return false;
+        if (tile > max_tile) max_tile = tile;
+    }
+
+    level_file_header_t header = {};
+    std::memcpy(header.magic, LEVEL_FILE_MAGIC, 4);
+    header.version = LEVEL_FILE_VERSION;
+    header.width = (uint32_t) map.width;
+    header.height = (uint32_t) map.height;
+    header.palette_count = (uint32_t) max_tile + 1;
+    header.palette_offset = align8(sizeof(level_file_header_t));
+    header.tiles_offset = align8(header.palette_offset + header.palette_count * sizeof(level_palette_entry_t));
+    header.collision_offset = align8(header.tiles_offset + header.width * header.height);
+    header.collision_words = (header.width + 63) / 64;
+    header.file_size = header.collision_offset + header.collision_words * header.height * 8;
+
+    std::vector<unsigned char> buffer(header.file_size, 0);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    level_palette_entry_t *palette = (level_palette_entry_t *) (buffer.data() + header.palette_offset);
+    for (int tile = 1; tile <= max_tile; tile++) {
+        palette[tile].src_x = (uint16_t) (128 * (tile - 1));
+        palette[tile].src_y = 0;
+        palette[tile].solid = 1;
+    }
+
+    uint8_t *tiles = buffer.data() + header.tiles_offset;
+    uint64_t *collision = (uint64_t *) (buffer.data() + header.collision_offset);
+    for (int y = 0; y < map.height; y++) {
+        for (int x = 0; x < map.width; x++) {
+            int tile = map.map[y * map.width + x];
+            tiles[y * map.width + x] = (uint8_t) tile;
+            if (palette[tile].solid) collision[y * header.collision_words + (x >> 6)] |= 1ULL << (x & 63);
+        }
+    }
+
+    // Zapis do pliku tymczasowego i podmiana - czytelnik nigdy nie widzi połowy pliku
+    std::string tmp_path = std::string(path) + ".tmp";
+    FILE *file = std::fopen(tmp_path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    std::remove(path);
+#endif
+    return std::rename(tmp_path.c_str(), path) == 0;
+}
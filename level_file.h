@@ -0,0 +1,113 @@
+#ifndef MYGAME_LEVEL_FILE_H
+#define MYGAME_LEVEL_FILE_H
+
+#include "game.h"
+#include <cstddef>
+#include <cstdint>
+
+// Binarny format poziomu (*.sgdl), wszystkie liczby little-endian:
+//
+//   level_file_header_t
+//   level_palette_entry_t[palette_count] - typy kafelków (indeks = id kafelka)
+//   uint8_t[width * height]              - id kafelków, wiersz po wierszu
+//   uint64_t[collision_words * height]   - warstwa kolizji, 1 bit na kafelek
+//
+// Sekcje są wyrównane do 8 bajtów, więc plik zmapowany do pamięci (mmap)
+// można czytać bezpośrednio, bez kopiowania ani parsowania.
+#define LEVEL_FILE_MAGIC "SGDL"
+#define LEVEL_FILE_VERSION 1
+
+struct level_file_header_t {
+    char magic[4];
+    uint32_t version;
+    uint32_t width, height;      // rozmiar w kafelkach
+    uint32_t palette_count;
+    uint32_t palette_offset;
+    uint32_t tiles_offset;
+    uint32_t collision_offset;
+    uint32_t collision_words;    // liczba słów uint64_t na wiersz warstwy kolizji
+    uint32_t file_size;
+};
+
+// Typ kafelka: położenie grafiki w teksturze kafelków i flagi
+struct level_palette_entry_t {
+    uint16_t src_x, src_y;
+    uint8_t solid;
+    uint8_t reserved[3];
+};
+
+static_assert(sizeof(level_file_header_t) == 40, "level_file_header_t layout");
+static_assert(sizeof(level_palette_entry_t) == 8, "level_palette_entry_t layout");
+
+// Poziom wczytany z pliku przez mmap. Dane nie są kopiowane - get() czyta
+// bezpośrednio ze zmapowanego pliku. Interfejs (width, height, get) jest taki
+// sam jak game_map_t, więc fizyka i rysowanie działają na obu typach.
+//
+// Mapowanie dzieli strony z plikiem: zapis pliku w miejscu (bez rename)
+// zmienia dane pod działającą grą, a obcięcie go kończy się SIGBUS przy
+// odczycie. write_level_file zapisuje przez plik tymczasowy i rename, więc
+// mapowanie zostaje przy starym pliku. Z copy = true plik jest czytany raz
+// do własnej pamięci i sprawdzany tak samo - dla plików zapisywanych
+// w miejscu (level_manager_t wykrywa je po numerze i-węzła).
+class mapped_level_t {
+public:
+    int width, height;
+    unsigned revision = 0;
+
+    // Rzuca std::runtime_error, jeśli pliku nie da się otworzyć lub jest uszkodzony
+    explicit mapped_level_t(const char *path, bool copy = false);
+    ~mapped_level_t();
+
+    mapped_level_t(const mapped_level_t &) = delete;
+    mapped_level_t &operator=(const mapped_level_t &) = delete;
+
+    int get(int x, int y) const {
+        if (x < 0) return 1;
+        if (x >= width) return 1;
+        if (y < 0) return 1;
+        if (y >= height) return 1;
+        return tiles[y * width + x];
+    }
+
+    bool solid(int x, int y) const {
+        if (x < 0 || x >= width || y < 0 || y >= height) return true;
+        return (collision[y * collision_words + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    const level_palette_entry_t &tile_type(int tile) const {
+        return palette[tile < (int) palette_count ? tile : 0];
+    }
+
+    const void *data() const { return mapping; }
+    size_t size() const { return mapping_size; }
+
+    // Numer i-węzła wczytanego pliku, 0 gdy nieznany (Windows)
+    uint64_t file_id() const { return inode; }
+
+private:
+    void unmap();
+
+    void *mapping = nullptr;
+    size_t mapping_size = 0;
+    uint64_t *owned = nullptr; // kopia pliku (copy = true), wyrównana do 8 bajtów jak sekcje
+    uint64_t inode = 0;
+#ifdef _WIN32
+    void *file_handle = nullptr;
+    void *mapping_handle = nullptr;
+#endif
+    const level_palette_entry_t *palette = nullptr;
+    uint32_t palette_count = 0;
+    const uint8_t *tiles = nullptr;
+    const uint64_t *collision = nullptr;
+    int collision_words = 0;
+};
+
+// Numer i-węzła pliku path, 0 gdy pliku nie ma albo numer jest nieznany (Windows).
+// Zapis w miejscu go nie zmienia, zapis przez plik tymczasowy i rename tak.
+uint64_t level_file_id(const char *path);
+
+// Zapisuje mapę w formacie *.sgdl. Kafelek o id n > 0 jest pełny i ma grafikę
+// w kolumnie 128 * (n - 1) tekstury kafelków, jak w draw_map().
+bool write_level_file(const char *path, const game_map_t &map);
+
+#endif
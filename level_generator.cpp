@@ -0,0 +1,178 @@
+#include "level_generator.h"
+#include "determinism.h"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+// splitmix64 - rozkłada ziarno, indeks segmentu i numer próby na niezależne ciągi
+static uint64_t mix(uint64_t v) {
+    v += 0x9e3779b97f4a7c15ULL;
+    v = (v ^ (v >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    v = (v ^ (v >> 27)) * 0x94d049bb133111ebULL;
+    return v ^ (v >> 31);
+}
+
+// Liczba z przedziału lo..hi (włącznie)
+static int random_range(uint64_t &state, int lo, int hi) {
+    return lo + (int) (next_random(state) % (uint64_t) (hi - lo + 1));
+}
+
+// Kolumna podłoża: pełne kafelki od wiersza top do dołu mapy
+static void fill_column(game_map_t &map, std::vector<int> &surface, int x, int top) {
+    for (int y = top; y < map.height; y++) map.map[(size_t) y * map.width + x] = 1;
+    surface[x] = top;
+}
+
+// Losowy układ segmentu: podłoże z uskokami o 1-2 kafelki (skok sięga ~2.6
+// kafelka w górę), dziury po 1-2 kolumny, słupki i wiszące platformy.
+// Pierwsze 4 i ostatnie 3 kolumny to równe podłoże: na początku gracz ląduje
+// po reset_player, z końca wychodzi za prawą krawędź.
+static void random_layout(game_map_t &map, uint64_t state) {
+    const int w = map.width, h = map.height;
+    const int lowest = h - 1, highest = std::max(3, h - 7); // zakres wierszy powierzchni podłoża
+    std::fill(map.map.begin(), map.map.end(), 0);
+    std::vector<int> surface((size_t) w, h); // h - kolumna bez podłoża
+
+    int ground = random_range(state, h - 4, h - 2);
+    int x = 0, last = ground; // last - powierzchnia ostatniej pełnej kolumny
+    // Kolumna podłoża w x, nie wyżej niż da się doskoczyć z ostatniej pełnej
+    // kolumny: 2 kafelki, a za dziurą 1 (w skoku nad dziurą gracz wznosi się
+    // i przesuwa naraz)
+    auto column = [&](int top) {
+        last = std::max(top, last - (surface[x - 1] == h ? 1 : 2));
+        fill_column(map, surface, x++, last);
+    };
+    for (; x < 4; x++) fill_column(map, surface, x, ground);
+    while (x < w - 3) {
+        int feature = random_range(state, 0, 7);
+        if (feature <= 3) {
+            // Równy odcinek, najwyżej 2 kafelki wyżej lub niżej
+            ground = std::min(lowest, std::max(highest, ground + random_range(state, -2, 2)));
+            for (int n = random_range(state, 2, 6); n > 0 && x < w - 3; n--) column(ground);
+            ground = last;
+        } else if (feature <= 5) {
+            // Dziura i co najmniej 2 kolumny lądowiska za nią; skok z miejsca
+            // przelatuje ~2 kafelki, więc za dziurą na 2 kolumny podłoże jest 2 niżej
+            int gap = ground + 2 <= lowest ? random_range(state, 1, 2) : 1;
+            x = std::min(w - 3, x + gap);
+            int drop = gap == 1 ? random_range(state, -1, 1) : 2;
+            ground = std::min(lowest, std::max(highest, ground + drop));
+            for (int n = 2; n > 0 && x < w - 3; n--) column(ground);
+            ground = last;
+        } else if (feature == 6) {
+            // Szersza dziura z filarem pośrodku
+            if (x + 4 > w - 3) continue;
+            x++;
+            column(std::max(highest, ground - random_range(state, 0, 1)));
+            column(last);
+            x++;
+            ground = std::min(lowest, std::max(highest, last + random_range(state, 0, 1)));
+        } else {
+            // Słupek 1-2 kafelki nad podłożem
+            int top = std::max(1, ground - random_range(state, 1, 2));
+            for (int n = random_range(state, 1, 2); n > 0 && x < w - 3; n--) column(top);
+            for (int n = 2; n > 0 && x < w - 3; n--) column(ground);
+        }
+    }
+    while (x < w) column(ground);
+
+    // Wiszące platformy 2 kafelki nad podłożem - tyle, ile skok z miejsca
+    // (poza kolumnami startu, przez które gracz spada po reset_player)
+    for (int n = w / 10; n > 0; n--) {
+        int px = random_range(state, 5, w - 6);
+        int length = random_range(state, 2, 4);
+        int row = surface[px] - 2;
+        if (row < 2) continue;
+        // Pod platformą i obok niej gracz musi się zmieścić (wolny wiersz)
+        for (int i = px; i < px + length && i < w - 3; i++) {
+            if (std::min(surface[i - 1], std::min(surface[i], surface[i + 1])) < row + 2) break;
+            map.map[(size_t) row * w + i] = 1;
+        }
+    }
+}
+
+// Równa podłoga na przedostatnim wierszu
+static void flat_layout(game_map_t &map) {
+    std::fill(map.map.begin(), map.map.end(), 0);
+    for (int x = 0; x < map.width; x++) map.map[(size_t) (map.height - 2) * map.width + x] = 1;
+}
+
+std::unique_ptr<generated_level_t> generate_segment(uint64_t seed, long long index, int width, int height) {
+    if (width < 8 || height < 6) throw std::invalid_argument("generate_segment: segment too small");
+    std::unique_ptr<generated_level_t> level(new generated_level_t);
+    level->index = index;
+    level->seed = seed;
+    level->map = {width, height, std::vector<int>((size_t) width * height, 0)};
+
+    nav_query_t query;
+    for (int attempt = 0; attempt <= LEVEL_GENERATOR_ATTEMPTS; attempt++) {
+        if (attempt < LEVEL_GENERATOR_ATTEMPTS) {
+            random_layout(level->map, mix(mix(seed ^ mix((uint64_t) index)) + (uint64_t) attempt) | 1);
+        } else {
+            flat_layout(level->map);
+        }
+        level->attempts = attempt + 1;
+        level->collision = packed_map_t(level->map);
+        level->navigation = nav_graph_t(level->collision);
+
+        // Pole, na które spada gracz po reset_player, i najwyższe pole ostatniej kolumny
+        level->start_cell = level->navigation.cell_at(1, 1, height);
+        level->exit_cell = -1;
+        for (int row = 0; row < height && level->exit_cell < 0; row++) {
+            level->exit_cell = level->navigation.cell(width - 1, row);
+        }
+        if (level->start_cell >= 0 && level->exit_cell >= 0 &&
+            query.find_path(level->navigation, level->start_cell, level->exit_cell)) {
+            break;
+        }
+    }
+    return level;
+}
+
+level_stream_t::level_stream_t(uint64_t seed, int width, int height, int ahead)
+        : seed(seed), width(width), height(height), ahead(ahead) {
+    if (width < 8 || height < 6 || ahead < 1) throw std::invalid_argument("level_stream_t: invalid parameters");
+    slots.reset(new std::atomic<generated_level_t *>[(size_t) ahead]);
+    for (int i = 0; i < ahead; i++) slots[i].store(nullptr);
+    generator = std::thread(&level_stream_t::generator_loop, this);
+}
+
+level_stream_t::~level_stream_t() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    space_cv.notify_one();
+    generator.join();
+    for (int i = 0; i < ahead; i++) delete slots[i].load();
+}
+
+void level_stream_t::generator_loop() {
+    for (long long index = 0;; index++) {
+        std::atomic<generated_level_t *> &slot = slots[index % ahead];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            space_cv.wait(lock, [&] { return stopping || slot.load(std::memory_order_acquire) == nullptr; });
+            if (stopping) return;
+        }
+        generated_level_t *level = generate_segment(seed, index, width, height).release();
+        slot.store(level, std::memory_order_release);
+        // Pusta sekcja krytyczna: next() sprawdza slot pod blokadą, więc nie przegapi powiadomienia
+        { std::lock_guard<std::mutex> lock(mutex); }
+        ready_cv.notify_one();
+    }
+}
+
+std::unique_ptr<generated_level_t> level_stream_t::next() {
+    std::atomic<generated_level_t *> &slot = slots[consumed % ahead];
+    generated_level_t *level = slot.exchange(nullptr, std::memory_order_acq_rel);
+    if (!level) {
+        stalls++;
+        std::unique_lock<std::mutex> lock(mutex);
+        ready_cv.wait(lock, [&] { return (level = slot.exchange(nullptr, std::memory_order_acq_rel)) != nullptr; });
+    }
+    consumed++;
+    { std::lock_guard<std::mutex> lock(mutex); }
+    space_cv.notify_one();
+    return std::unique_ptr<generated_level_t>(level);
+}
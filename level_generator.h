@@ -0,0 +1,70 @@
+#ifndef MYGAME_LEVEL_GENERATOR_H
+#define MYGAME_LEVEL_GENERATOR_H
+
+#include "game.h"
+#include "nav.h"
+#include "packed_map.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Najwięcej losowanych układów segmentu przed użyciem płaskiej podłogi
+#define LEVEL_GENERATOR_ATTEMPTS 16
+
+// Segment poziomu wygenerowany proceduralnie: mapa w postaci gry, warstwa
+// kolizji i graf nawigacji (zbudowany przy sprawdzaniu osiągalności)
+struct generated_level_t {
+    long long index = 0;
+    uint64_t seed = 0;
+    int attempts = 0; // ile układów wygenerowano, zanim któryś dał się przejść
+    int start_cell = -1; // pole grafu, na które spada gracz po reset_player
+    int exit_cell = -1;  // najwyższe pole ostatniej kolumny
+    game_map_t map = {0, 0, {}};
+    packed_map_t collision;
+    nav_graph_t navigation;
+};
+
+// Generuje segment index poziomu dla ziarna seed. Wynik zależy tylko od
+// (seed, index, width, height). Gracz zaczyna jak po reset_player (1, 1)
+// i musi dać się doprowadzić do ostatniej kolumny fizyką update_player:
+// każdy układ jest sprawdzany grafem nawigacji (nav_graph_t), a układ bez
+// ścieżki jest odrzucany i losowany od nowa. Po LEVEL_GENERATOR_ATTEMPTS
+// nieudanych próbach zostaje płaska podłoga, która zawsze jest przechodnia.
+std::unique_ptr<generated_level_t> generate_segment(uint64_t seed, long long index, int width = 40, int height = 15);
+
+// Strumień kolejnych segmentów generowanych w tle. Wątek generatora trzyma
+// `ahead` gotowych segmentów przed graczem w atomowych wskaźnikach; next()
+// zabiera następny segment zamianą wskaźnika na nullptr (bez blokady),
+// a czeka tylko wtedy, gdy generator nie nadąża (stalls).
+class level_stream_t {
+public:
+    level_stream_t(uint64_t seed, int width = 40, int height = 15, int ahead = 2);
+    ~level_stream_t();
+
+    level_stream_t(const level_stream_t &) = delete;
+    level_stream_t &operator=(const level_stream_t &) = delete;
+
+    // Kolejny segment (indeksy 0, 1, 2, ...); segment należy do wywołującego
+    std::unique_ptr<generated_level_t> next();
+
+    long long stalls = 0; // wywołania next(), które musiały czekać na generator
+
+private:
+    void generator_loop();
+
+    const uint64_t seed;
+    const int width, height, ahead;
+    std::unique_ptr<std::atomic<generated_level_t *>[]> slots; // segment k w slots[k % ahead]
+    long long consumed = 0;
+
+    std::mutex mutex; // tylko do usypiania wątków, nie chroni slotów
+    std::condition_variable space_cv; // zwolniono slot
+    std::condition_variable ready_cv; // wypełniono slot
+    bool stopping = false;
+    std::thread generator;
+};
+
+#endif
@@ -0,0 +1,209 @@
+#include "level_manager.h"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+std::vector<std::string> find_level_files(const char *dir) {
+    std::vector<std::string> paths;
+    for (int i = 1;; i++) {
+        std::string path = std::string(dir) + "/level" + std::to_string(i) + ".sgdl";
+        FILE *file = std::fopen(path.c_str(), "rb");
+        if (!file) break;
+        std::fclose(file);
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+level_manager_t::level_manager_t(std::vector<std::string> level_paths, int preload_radius)
+        : paths(std::move(level_paths)), slots(new std::atomic<level_entry_t *>[paths.size()]),
+          reloaded(new std::atomic<level_entry_t *>[paths.size()]),
+          file_ids(new std::atomic<uint64_t>[paths.size()]), preload_radius(preload_radius),
+          pending(paths.size(), 0), reload_pending(paths.size(), 0) {
+    if (paths.empty()) throw std::runtime_error("No level files");
+    for (size_t i = 0; i < paths.size(); i++) {
+        slots[i].store(nullptr);
+        reloaded[i].store(nullptr);
+        file_ids[i].store(0);
+    }
+
+    load(0);
+    sync_loads++;
+    worker = std::thread(&level_manager_t::worker_loop, this);
+    switch_to(0);
+}
+
+level_manager_t::~level_manager_t() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_cv.notify_one();
+    if (worker.joinable()) worker.join();
+    for (size_t i = 0; i < paths.size(); i++) {
+        delete slots[i].load();
+        delete reloaded[i].load();
+    }
+}
+
+level_manager_t::level_entry_t *level_manager_t::load(int handle) {
+    level_entry_t *level = slots[handle].load(std::memory_order_acquire);
+    if (level) return level;
+
+    // Bez blokady: wątek gry i wątek w tle mogą zbudować ten sam poziom
+    // naraz - zostaje pierwsza wersja, a wersja z reload() podmieniona przez
+    // apply_reloads() nigdy nie zostanie nadpisana spóźnionym wczytaniem
+    level = new level_entry_t(paths[handle].c_str(), false);
+    file_ids[handle].store(level->file.file_id(), std::memory_order_release);
+    level_entry_t *expected = nullptr;
+    if (!slots[handle].compare_exchange_strong(expected, level, std::memory_order_acq_rel)) {
+        delete level;
+        return expected;
+    }
+    return level;
+}
+
+level_manager_t::level_entry_t *level_manager_t::entry(int handle) {
+    level_entry_t *level = slots[handle].load(std::memory_order_acquire);
+    if (level) return level;
+    sync_loads++;
+    return load(handle);
+}
+
+const mapped_level_t *level_manager_t::operator[](int handle) {
+    return &entry(handle)->file;
+}
+
+const packed_map_t *level_manager_t::collision_map(int handle) {
+    return &entry(handle)->collision;
+}
+
+const collision_rects_t *level_manager_t::solid_rects(int handle) {
+    return &entry(handle)->rects;
+}
+
+const nav_graph_t *level_manager_t::navigation(int handle) {
+    return &entry(handle)->navigation;
+}
+
+const mapped_level_t *level_manager_t::switch_to(int handle) {
+    level_entry_t *level = entry(handle);
+    current = handle;
+    current_map = &level->file;
+    current_packed = &level->collision;
+    for (int d = 1; d <= preload_radius; d++) {
+        request_preload((handle + d) % size());
+        request_preload((handle - d + size()) % size());
+    }
+    return current_map;
+}
+
+const mapped_level_t *level_manager_t::transition(player_t &player) {
+    try {
+        int handle = level_transition(player, *this, current);
+        return handle != current ? switch_to(handle) : current_map;
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "Couldn't load level: %s\n", e.what());
+        failed_loads++;
+        reset_player(player);
+        return current_map;
+    }
+}
+
+bool level_manager_t::reload(const std::string &path) {
+    for (int handle = 0; handle < size(); handle++) {
+        if (paths[handle] != path) continue;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            reload_pending[handle] = 1;
+        }
+        queue_cv.notify_one();
+        return true;
+    }
+    return false;
+}
+
+int level_manager_t::apply_reloads(long long stamp) {
+    if (!reload_ready.exchange(false, std::memory_order_acquire)) return 0;
+    int applied = 0;
+    for (int handle = 0; handle < size(); handle++) {
+        level_entry_t *level = reloaded[handle].exchange(nullptr, std::memory_order_acq_rel);
+        if (!level) continue;
+        level_entry_t *old = slots[handle].exchange(level, std::memory_order_acq_rel);
+        if (old) retired.push_back({stamp, std::unique_ptr<level_entry_t>(old)});
+        if (handle == current) {
+            current_map = &level->file;
+            current_packed = &level->collision;
+        }
+        applied++;
+    }
+    reloads += applied;
+    return applied;
+}
+
+void level_manager_t::release_retired(long long reader_stamp) {
+    if (retired.empty()) return;
+    retired.erase(std::remove_if(retired.begin(), retired.end(),
+                                 [&](const retired_level_t &r) { return r.stamp < reader_stamp; }),
+                  retired.end());
+}
+
+void level_manager_t::request_preload(int handle) {
+    if (slots[handle].load(std::memory_order_acquire)) return;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        pending[handle] = 1;
+    }
+    queue_cv.notify_one();
+}
+
+void level_manager_t::worker_loop() {
+    for (;;) {
+        int handle = -1;
+        bool reloading = false;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            for (;;) {
+                if (stopping) return;
+                for (int i = 0; i < size() && handle < 0; i++) {
+                    if (reload_pending[i]) {
+                        reload_pending[i] = 0;
+                        handle = i;
+                        reloading = true;
+                    } else if (pending[i]) {
+                        pending[i] = 0;
+                        handle = i;
+                    }
+                }
+                if (handle >= 0) break;
+                queue_cv.wait(lock);
+            }
+        }
+        if (reloading) {
+            // Poziom jeszcze niewczytany i tak zostanie wczytany z nowego pliku
+            if (!slots[handle].load(std::memory_order_acquire)) continue;
+            try {
+                // Ten sam i-węzeł co wczytana wersja - plik zapisany w miejscu
+                const uint64_t id = level_file_id(paths[handle].c_str());
+                const bool in_place = id != 0 && id == file_ids[handle].load(std::memory_order_acquire);
+                level_entry_t *level = new level_entry_t(paths[handle].c_str(), in_place);
+                file_ids[handle].store(level->file.file_id(), std::memory_order_release);
+                // Wersja, której wątek gry jeszcze nie podmienił, nie była nigdzie używana
+                delete reloaded[handle].exchange(level, std::memory_order_acq_rel);
+                reload_ready.store(true, std::memory_order_release);
+            } catch (const std::exception &e) {
+                // Np. plik zapisany w połowie - zostaje poprzednia wersja
+                std::fprintf(stderr, "Couldn't reload level: %s\n", e.what());
+            }
+            continue;
+        }
+        if (slots[handle].load(std::memory_order_acquire)) continue;
+        try {
+            load(handle);
+            preloads++;
+        } catch (const std::exception &e) {
+            // Błąd zostanie zgłoszony ponownie przy synchronicznym wczytaniu
+            std::fprintf(stderr, "Couldn't preload level: %s\n", e.what());
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#ifndef MYGAME_LEVEL_MANAGER_H
+#define MYGAME_LEVEL_MANAGER_H
+
+#include "collision_rects.h"
+#include "game.h"
+#include "level_file.h"
+#include "nav.h"
+#include "packed_map.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Zwraca ścieżki dir/level1.sgdl, dir/level2.sgdl, ... aż do pierwszego brakującego pliku
+std::vector<std::string> find_level_files(const char *dir);
+
+// Właściciel wszystkich poziomów gry. Poziom jest wskazywany uchwytem
+// (indeksem), a przełączenie to zamiana wskaźnika - bez kopiowania mapy
+// i bez alokacji. Sąsiednie poziomy są wczytywane w wątku w tle, więc
+// przejście nie zatrzymuje klatki. Plik poziomu jest mapowany (mmap, bez
+// kopiowania); zapis przez rename (write_level_file) nie rusza mapowania.
+// Gdy reload() znajdzie pod ścieżką ten sam i-węzeł, plik był zapisany
+// w miejscu - od tej wersji poziom jest kopiowany do pamięci (copy = true),
+// żeby kolejne takie zapisy nie zmieniały ani nie obcinały danych gry.
+// Zmiana pliku zapisanego w miejscu przed pierwszym reload() trafia jeszcze
+// do zmapowanej wersji.
+// Razem z plikiem budowana jest zwarta warstwa kolizji (packed_map_t)
+// używana przez fizykę, scalone prostokąty pełnych kafelków
+// (collision_rects_t) dla promieni i szerokich obiektów oraz graf
+// nawigacji (nav_graph_t) dla agentów.
+class level_manager_t {
+public:
+    // Wczytuje pierwszy poziom od razu; rzuca std::runtime_error, gdy się nie da
+    explicit level_manager_t(std::vector<std::string> paths, int preload_radius = 1);
+    ~level_manager_t();
+
+    level_manager_t(const level_manager_t &) = delete;
+    level_manager_t &operator=(const level_manager_t &) = delete;
+
+    int size() const { return (int) paths.size(); }
+
+    // Poziom o danym uchwycie; jeśli nie został jeszcze wczytany w tle,
+    // jest wczytywany synchronicznie (liczone w sync_loads)
+    const mapped_level_t *operator[](int handle);
+
+    // Warstwa kolizji poziomu (wczytuje poziom jak operator[])
+    const packed_map_t *collision_map(int handle);
+
+    // Prostokąty pełnych kafelków poziomu (wczytuje poziom jak operator[])
+    const collision_rects_t *solid_rects(int handle);
+
+    // Graf nawigacji poziomu (wczytuje poziom jak operator[])
+    const nav_graph_t *navigation(int handle);
+
+    // Czy poziom jest już wczytany - wtedy operator[] i switch_to nie wczytują
+    // go synchronicznie ani nic nie alokują
+    bool resident(int handle) const { return slots[handle].load(std::memory_order_acquire) != nullptr; }
+
+    int current_handle() const { return current; }
+    const mapped_level_t *current_level() const { return current_map; }
+    const packed_map_t *current_collision() const { return current_packed; }
+
+    // Przełącza bieżący poziom i zleca wczytanie jego sąsiadów w tle.
+    // Rzuca std::runtime_error, gdy poziomu nie da się wczytać - bieżący
+    // poziom się wtedy nie zmienia.
+    const mapped_level_t *switch_to(int handle);
+
+    // Przejście między poziomami, gdy gracz wyjdzie poza krawędź mapy. Nie
+    // rzuca: gdy poziomu docelowego nie da się wczytać (brak pliku, plik
+    // uszkodzony albo zapisany w połowie), błąd trafia na stderr, gracz
+    // wraca na początek bieżącego poziomu, a licznik failed_loads rośnie.
+    const mapped_level_t *transition(player_t &player);
+
+    // Zleca ponowne wczytanie poziomu z pliku path w wątku w tle (np. po
+    // zapisaniu go przez level_convert); false, gdy to nie jest plik
+    // żadnego wczytanego poziomu. Można wywołać z dowolnego wątku.
+    bool reload(const std::string &path);
+
+    // Podmienia poziomy wczytane ponownie przez reload() - wywołuje wątek,
+    // który przełącza poziomy (switch_to). Stan gracza się nie zmienia.
+    // Nie czeka na wczytywanie w tle (same zamiany wskaźników).
+    // Wskaźniki na poprzednie wersje mogą jeszcze trzymać inne wątki (np.
+    // rysowanie), więc są odkładane z numerem stamp ostatniego stanu
+    // opublikowanego przed podmianą. Zwraca liczbę podmian.
+    int apply_reloads(long long stamp);
+
+    // Zwalnia wersje odłożone przez apply_reloads() przed stanem
+    // reader_stamp - czytelnik, który doszedł do późniejszego stanu, nie
+    // trzyma już wskaźników na nie. Ten sam wątek co apply_reloads().
+    void release_retired(long long reader_stamp);
+
+    std::atomic<long long> preloads{0};   // poziomy wczytane w tle
+    std::atomic<long long> reloads{0};    // poziomy podmienione przez apply_reloads()
+    std::atomic<long long> sync_loads{0}; // poziomy wczytane w wątku gry (przestój)
+    std::atomic<long long> failed_loads{0}; // nieudane przejścia (transition)
+
+private:
+    struct level_entry_t {
+        mapped_level_t file;
+        packed_map_t collision;
+        collision_rects_t rects;
+        nav_graph_t navigation;
+
+        level_entry_t(const char *path, bool copy)
+                : file(path, copy), collision(file), rects(collision), navigation(collision) {}
+    };
+
+    level_entry_t *load(int handle);
+    level_entry_t *entry(int handle);
+    void request_preload(int handle);
+    void worker_loop();
+
+    std::vector<std::string> paths;
+    std::unique_ptr<std::atomic<level_entry_t *>[]> slots;
+    std::unique_ptr<std::atomic<level_entry_t *>[]> reloaded; // nowe wersje czekające na apply_reloads()
+    std::unique_ptr<std::atomic<uint64_t>[]> file_ids; // i-węzeł ostatnio wczytanej wersji
+    std::atomic<bool> reload_ready{false};
+    struct retired_level_t {
+        long long stamp; // ostatni stan opublikowany ze starą wersją
+        std::unique_ptr<level_entry_t> level;
+    };
+
+    std::vector<retired_level_t> retired; // zastąpione wersje (tylko wątek apply_reloads)
+    int preload_radius;
+    int current = 0;
+    const mapped_level_t *current_map = nullptr;
+    const packed_map_t *current_packed = nullptr;
+
+    // Kolejka zleceń dla wątku w tle: flagi zamiast kontenera, żeby
+    // zlecanie z wątku gry nie alokowało pamięci
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::vector<char> pending;
+    std::vector<char> reload_pending;
+    bool stopping = false;
+    std::thread worker;
+};
+
+#endif
@@ -1,275 +1,57 @@
 #include "SDL2/SDL.h"
+#include "asset_loader.h"
+#include "audio_mixer.h"
+#include "camera.h"
+#include "file_watcher.h"
+#include "game.h"
+#include "input.h"
+#include "input_log.h"
+#include "level_manager.h"
+#include "profiler.h"
+#include "render.h"
+#include "snapshot.h"
+#include "timestep.h"
+#include "triple_buffer.h"
+#include <atomic>
 #include <iostream>
 #include <memory>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
 #include <thread>
 #include <vector>
 
-#define TILE_SIZE 64
-
-// Struktura przechowująca mapę gry
-struct game_map_t {
-    int width, height;
-    std::vector<int> map;
-
-    int get(int x, int y) const {
-        if (x < 0) return 1;
-        if (x >= width) return 1;
-        if (y < 0) return 1;
-        if (y >= height) return 1;
-        return map[y * width + x];
-    }
-};
-
-// Przykładowa mapa gry (poziom 1)
-game_map_t game_map1 = {
-        20, 15, {
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 0, 1, 0, 0, 0, 1, 1
-        }
-};
-
-// Przykładowa mapa gry (poziom 2)
-game_map_t game_map2 = {
-        20, 15, {
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0, 0, 1, 1
-        }
-};
-game_map_t game_map3 = {
-        20, 15, {
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0,
-                0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
-                0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
-                0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-                1, 1, 1, 1, 0, 1, 1, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0, 0, 1, 1
-        }
+// Stan gry publikowany przez wątek symulacji do rysowania
+struct frame_snapshot_t {
+    player_t previous;                 // stan z przedostatniego kroku (do interpolacji)
+    player_t player;                   // stan po ostatnim kroku
+    const mapped_level_t *map;         // bieżący poziom (żyje, dopóki rysowanie nie dojdzie do późniejszego stanu)
+    int map_handle;
+    bool player_texture1;              // klatka animacji gracza
+    long long tick;                    // numer ostatniego kroku
+    long long sequence;                // numer publikacji (rośnie też po cofnięciu czasu)
+    std::chrono::steady_clock::time_point tick_time; // chwila, w której kończy się ostatni krok
 };
-std::vector<game_map_t*> game_maps = {&game_map1, &game_map2,&game_map3};
-int current_map_index = 0;
-
-// Struktura przechowująca wektor dwuwymiarowy
-union vect_t {
-    struct {
-        double x;
-        double y;
-    } v;
-    double p[2];
-};
-
-// Przeciążenie operatora + dla wektora
-vect_t operator+(const vect_t a, const vect_t b) {
-    vect_t ret = a;
-    ret.v.x += b.v.x;
-    ret.v.y += b.v.y;
-    return ret;
-}
-
-// Przeciążenie operatora * dla wektora i liczby
-vect_t operator*(const vect_t a, const double b) {
-    vect_t ret = a;
-    ret.v.x *= b;
-    ret.v.y *= b;
-    return ret;
-}
-
-// Struktura przechowująca informacje o graczu
-struct player_t {
-    vect_t p; // pozycja
-    vect_t v; // prędkość
-    vect_t a; // przyspieszenie
-};
-
-// Funkcja sprawdzająca, czy dany punkt jest w kolizji z mapą gry
-bool is_in_collision(vect_t pos, const game_map_t &map) {
-    return map.get((int) pos.v.x, (int) pos.v.y) > 0;
-}
-
-// Funkcja sprawdzająca, czy gracz stoi na ziemi (jest na podłożu)
-bool is_on_the_ground(player_t player, const game_map_t &map) {
-    return map.get((int) player.p.v.x, (int) (player.p.v.y + 0.01)) > 0;
-}
-// Funkcja resetująca gracza na początek mapy
-void reset_player(player_t &player) {
-    player.p.v.x = 1;
-    player.p.v.y = 1;
-    player.v.v.x = 0;
-    player.v.v.y = 0;
-
-}
-void reset_player_to_previous_map(player_t &player, game_map_t &map) {
-    // Ustawienie początkowej pozycji gracza na poprzedniej mapie
-    player.p.v.x = map.width - 2;  // Ustaw na drugi od końca kafelek
-    player.p.v.y = 1;
-    player.v.v.x = 0;
-    player.v.v.y = 0;
-
-    // Znalezienie indeksu poprzedniej mapy
-    int prev_map_index = current_map_index - 1;
-    if (prev_map_index < 0) {
-        prev_map_index = 0;
-    }
-
-    // Ustawienie aktualnej mapy na poprzednią mapę
-    current_map_index = prev_map_index;
-    map = *game_maps[current_map_index];
-}
-// Funkcja aktualizująca stan gracza na podstawie fizyki gry
-player_t update_player(player_t player_old, const game_map_t &map, double dt) {
-    player_t player = player_old;
-
-    // Ustawienie przyspieszenia ziemskiego, jeśli gracz nie stoi na ziemi
-    if (!is_on_the_ground(player_old, map)) {
-        player_old.a.v.y = 10; // przyspieszenie ziemskie (w powietrzu)
-    }
-
-    // Obliczenie nowej pozycji gracza
-    player.p = player_old.p + (player_old.v * dt) + (player_old.a * dt * dt) * 0.5;
-    // Obliczenie nowej prędkości gracza
-    player.v = player_old.v + (player_old.a * dt);
-    player.v = player.v * 0.99; // Zmniejszenie prędkości w wyniku tarcia
-
-    // Obsługa kolizji z blokami
-    std::vector<vect_t> collision_points = {
-            {{-0.4, 0.0}},
-            {{0.4,  0.0}}
-    };
-
-    std::vector<vect_t> collision_mods = {
-            {{0.0, -1.0}},
-            {{0.0, -1.0}}
-    };
-
-    for (int i = 0; i < collision_points.size(); i++) {
-        auto test_point = player.p + collision_points[i];
-
-        if (is_in_collision(test_point, map)) {
-            if (collision_mods[i].v.y < 0) {
-                // Jeśli kolizja z blokiem z dołu, zatrzymaj pionową prędkość
-                player.v.v.y = 0;
-                player.p.v.y = player_old.p.v.y;
-            } else {
-                // Jeśli kolizja z blokiem z innej strony, zatrzymaj cały ruch
-                player.v.v.x = 0;
-                player.v.v.y = 0;
-                player.p = player_old.p;
-            }
-        }
-    }
-
-    // Jeśli gracz spadnie poniżej mapy, zresetuj jego pozycję
-    if (player.p.v.y >= map.height - 0.5) {
-        reset_player(player);
-    }
-
-    return player;
-}
-
-void draw_map(SDL_Renderer *renderer, game_map_t &map, std::shared_ptr<SDL_Texture> tex) {
-    for (int y = map.height - 1; y >= 0; y--)
-        for (int x = 0; x < map.width; x++) {
-            SDL_Rect dst = {x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE};
-            if (map.get(x, y) > 0) {
-                SDL_Rect src = {128 * (map.get(x, y) - 1), 0, TILE_SIZE, TILE_SIZE};
-                SDL_RenderCopy(renderer, tex.get(), &src, &dst);
-            }
-        }
-}
-
-std::shared_ptr<SDL_Texture> load_image(SDL_Renderer *renderer, const char *path) {
-    SDL_Surface *surface = SDL_LoadBMP(path);
-    if (!surface) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface from image: %s", SDL_GetError());
-        throw std::invalid_argument(SDL_GetError());
-    }
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (!texture) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture from surface: %s", SDL_GetError());
-        SDL_FreeSurface(surface);
-        throw std::invalid_argument(SDL_GetError());
-    }
-    std::shared_ptr<SDL_Texture> tex(texture, SDL_DestroyTexture);
-    SDL_FreeSurface(surface);
-    return tex;
-}
-
-std::vector<std::shared_ptr<SDL_Texture>> load_player_textures(SDL_Renderer *renderer) {
-    std::vector<std::shared_ptr<SDL_Texture>> textures;
-
-    SDL_Surface *surface1 = SDL_LoadBMP("image/player.bmp");
-    if (!surface1) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface from image: %s", SDL_GetError());
-        throw std::invalid_argument(SDL_GetError());
-    }
-    SDL_SetColorKey(surface1, SDL_TRUE, SDL_MapRGB(surface1->format, 0, 255, 255));
-    SDL_Texture *texture1 = SDL_CreateTextureFromSurface(renderer, surface1);
-    if (!texture1) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture from surface: %s", SDL_GetError());
-        SDL_FreeSurface(surface1);
-        throw std::invalid_argument(SDL_GetError());
-    }
-    textures.emplace_back(texture1, SDL_DestroyTexture);
-    SDL_FreeSurface(surface1);
-
-    SDL_Surface *surface2 = SDL_LoadBMP("image/player2.bmp");
-    if (!surface2) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface from image: %s", SDL_GetError());
-        throw std::invalid_argument(SDL_GetError());
-    }
-    SDL_SetColorKey(surface2, SDL_TRUE, SDL_MapRGB(surface2->format, 0, 255, 255));
-    SDL_Texture *texture2 = SDL_CreateTextureFromSurface(renderer, surface2);
-    if (!texture2) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture from surface: %s", SDL_GetError());
-        SDL_FreeSurface(surface2);
-        throw std::invalid_argument(SDL_GetError());
-    }
-    textures.emplace_back(texture2, SDL_DestroyTexture);
-    SDL_FreeSurface(surface2);
-
-    return textures;
-}
 
 int main(int argc, char *argv[]) {
     using namespace std::chrono_literals;
     using namespace std::chrono;
     using namespace std;
 
+    double tick_rate = 60.0; // częstotliwość kroków fizyki (Hz)
+    int max_catch_up = 5;    // maksymalna liczba kroków fizyki na jedną klatkę
+    const char *record_path = nullptr; // log wejścia do odtworzenia w mygame_sim --replay
+    const char *profile_path = nullptr; // CSV z czasami faz klatek zapisywany przy wyjściu
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--tick-rate") && i + 1 < argc) tick_rate = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--max-catch-up") && i + 1 < argc) max_catch_up = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--record") && i + 1 < argc) record_path = argv[++i];
+        else if (!strcmp(argv[i], "--profile-csv") && i + 1 < argc) profile_path = argv[++i];
+    }
+    if (tick_rate <= 0) tick_rate = 60.0;
+    if (max_catch_up < 1) max_catch_up = 1;
+
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s", SDL_GetError());
         return 3;
@@ -277,106 +59,360 @@ int main(int argc, char *argv[]) {
 
     SDL_Window *window;
     SDL_Renderer *renderer;
+    // Renderowanie tak szybko, jak pozwala synchronizacja pionowa
+    SDL_SetHint(SDL_HINT_RENDER_VSYNC, "1");
     if (SDL_CreateWindowAndRenderer(800, 600, SDL_WINDOW_RESIZABLE, &window, &renderer)) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create window and renderer: %s", SDL_GetError());
         return 3;
     }
 
-    std::vector<std::shared_ptr<SDL_Texture>> player_textures = load_player_textures(renderer);
-    auto tiles_texture = load_image(renderer, "image/block.bmp");
-    auto background_texture = load_image(renderer, "image/background.bmp");
+    // Wszystkie obrazy w jednym atlasie: cała klatka to jedno SDL_RenderGeometry.
+    // Atlas jest wczytywany w tle; do tego czasu rysowana jest tekstura zastępcza.
+    enum { IMAGE_BACKGROUND, IMAGE_BLOCK, IMAGE_PLAYER, IMAGE_PLAYER2 };
+    const double upload_budget_ms = 2.0; // czas klatki na przesyłanie tekstur
+    std::unique_ptr<asset_loader_t> assets;
+    try {
+        assets.reset(new asset_loader_t(renderer));
+    } catch (const std::exception &) {
+        return 3; // błąd już zapisany w logu
+    }
+    texture_handle_t atlas = assets->load_atlas({{"Image/background.bmp", false},
+                                                 {"Image/block.bmp", false},
+                                                 {"Image/player.bmp", true},
+                                                 {"Image/player2.bmp", true}});
+    sprite_batch_t batch;
 
     bool still_playing = true;
-    player_t player = {{1, 1},
-                       {0, 0},
-                       {0, 0}};
 
-    double dt = 1.0 / 60.0;
-    double game_time = 0.0;
-    steady_clock::time_point current_time = steady_clock::now();
+    // Poziomy wczytywane z plików levels/level1.sgdl, level2.sgdl, ...
+    // (generowanych przez level_convert) zamiast map wkompilowanych w program
+    std::unique_ptr<level_manager_t> levels;
+    try {
+        levels.reset(new level_manager_t(find_level_files("levels")));
+    } catch (const std::exception &e) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't load levels: %s", e.what());
+        return 3;
+    }
+
+    // Efekty dźwiękowe; bez urządzenia dźwięku (błąd już w logu) gra działa bez nich
+    enum { SOUND_JUMP, SOUND_LAND, SOUND_LEVEL };
+    std::unique_ptr<audio_mixer_t> audio;
+    try {
+        audio.reset(new audio_mixer_t({"Sound/jump.wav", "Sound/land.wav", "Sound/level.wav"}));
+    } catch (const std::exception &) {
+    }
+
+    // Przeładowanie obrazów i poziomów zmienionych na dysku bez restartu gry
+    std::unique_ptr<file_watcher_t> watcher;
+    try {
+        watcher.reset(new file_watcher_t({"Image", "levels"}));
+    } catch (const std::exception &e) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Hot reload disabled: %s", e.what());
+    }
+    std::vector<std::string> changed_files;
+
+    // Nagrywanie wejścia: zdarzenia z numerem kroku, przed którym zostały zastosowane
+    std::unique_ptr<input_recorder_t> recorder;
+    if (record_path) {
+        try {
+            recorder.reset(new input_recorder_t(record_path, tick_rate));
+        } catch (const std::exception &e) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't record input: %s", e.what());
+            return 3;
+        }
+    }
 
-    bool is_player_texture1 = true; // Flaga do przełączania tekstur gracza
-    int player_frame_counter = 0;
+    // Fazy klatki mierzone profilerem; F3 - nakładka, F4 - zapis CSV.
+    // UPDATE to czas kroków fizyki wątku symulacji w czasie tej klatki.
+    enum { PHASE_EVENTS, PHASE_UPDATE, PHASE_UPLOAD, PHASE_DRAW, PHASE_PRESENT, PHASE_COUNT };
+    static const char *const phase_names[PHASE_COUNT] = {"EVENTS", "UPDATE", "UPLOAD", "DRAW", "PRESENT"};
+    profiler_t profiler(phase_names, PHASE_COUNT);
+
+    // Fizyka działa we własnym wątku i po każdej porcji kroków publikuje stan
+    // przez potrójny bufor; wątek okna rysuje najnowszy opublikowany stan.
+    // Wolne SDL_RenderPresent (czekanie na vsync) nie opóźnia fizyki, a
+    // fizyka nie blokuje rysowania.
+    player_t start_player = {{1, 1},
+                             {0, 0},
+                             {0, 0}};
+    frame_snapshot_t start_snapshot = {start_player, start_player, levels->current_level(),
+                                       levels->current_handle(), true, 0, 0, steady_clock::now()};
+    triple_buffer_t<frame_snapshot_t> snapshots(start_snapshot);
+    input_sampler_t input;
+    std::atomic<bool> simulating{true};
+    std::atomic<long long> sim_ticks{0};
+    // Numer stanu, który rysuje wątek okna; starsze wersje przeładowanych
+    // poziomów można wtedy zwolnić
+    std::atomic<long long> drawn_sequence{0};
+    fixed_timestep_t timestep(tick_rate, max_catch_up);
+    const double dt = timestep.dt;
+
+    // Cały stan rozgrywki; po zakończeniu wątku symulacji czytany przy wyjściu
+    game_state_t state = {start_player, start_player, levels->current_handle(), 0, 1, 0, 0,
+                          TRAJECTORY_HASH_START};
+    // Cofanie czasu (Backspace): zapis stanu po każdym kroku, ostatnie 10 s
+    const int rewind_seconds = 10;
+    std::atomic<int> rewind_requests{0};
+
+    std::thread simulation([&] {
+        snapshot_ring_t<game_state_t> history((int) (rewind_seconds * tick_rate));
+        const mapped_level_t *current_map = levels->current_level();
+
+        // Wejście stosowane przed krokiem fizyki, w którego czasie nastąpiło.
+        // Odrzucone wciśnięcia (gracz w powietrzu) nie trafiają do logu - w
+        // odtworzeniu też nic by nie zmieniły.
+        auto apply_key = [&](input_key_t key, bool pressed) {
+            if (pressed && !is_on_the_ground(state.player, *levels->current_collision())) return false;
+            if (recorder) recorder->record(state.tick, key, pressed);
+            bool accepted = apply_input(state.player, *levels->current_collision(), key, pressed);
+            if (accepted && key == INPUT_KEY_LEFT) state.player_texture1 = false;
+            if (accepted && key == INPUT_KEY_RIGHT) state.player_texture1 = true;
+            if (accepted && pressed && key == INPUT_KEY_UP && audio) audio->play(SOUND_JUMP);
+            if (!pressed && (key == INPUT_KEY_LEFT || key == INPUT_KEY_RIGHT)) state.player_frame_counter = 0;
+            return accepted;
+        };
+
+        long long published = 0;
+        steady_clock::time_point current_time = steady_clock::now();
+        while (simulating.load(std::memory_order_acquire)) {
+            // Poziomy przeładowane w tle; gracz zostaje tam, gdzie był. Numer
+            // stanu, a nie kroku, bo cofanie czasu zmniejsza state.tick.
+            if (levels->apply_reloads(published) > 0) current_map = levels->current_level();
+            levels->release_retired(drawn_sequence.load(std::memory_order_acquire));
+
+            // Cofnięcie o sekundę na każde wciśnięcie; log wejścia zakłada
+            // ciągłe kroki, więc przy nagrywaniu cofanie jest wyłączone
+            int rewinds = rewind_requests.exchange(0, std::memory_order_relaxed);
+            if (rewinds > 0 && !recorder && history.size() > 0) {
+                int age = (int) (rewinds * tick_rate);
+                if (age > history.size() - 1) age = history.size() - 1;
+                // Tylko do poziomu, który jest w pamięci - wczytanie go tutaj
+                // alokowałoby i budowało kolizje w kroku symulacji. Poziomy
+                // nie są zwalniane, więc w praktyce zapis jest zawsze dostępny.
+                while (age > 0 && !levels->resident(history.peek(age)->map_index)) age--;
+                if (levels->resident(history.peek(age)->map_index)) {
+                    history.restore(age, state);
+                    if (state.map_index != levels->current_handle()) {
+                        current_map = levels->switch_to(state.map_index);
+                    }
+                    state.previous_player = state.player;
+                    // Przyspieszenie z chwili zapisu zastępują klawisze trzymane teraz
+                    state.player.a.v.x = 0;
+                    state.player.a.v.y = 0;
+                    input.resync(apply_key);
+                }
+            }
 
-    game_map_t *current_map = &game_map1; // Ustawienie początkowej mapy
+            // Aktualizacja fizyki gry stałym krokiem dt
+            steady_clock::time_point new_time = steady_clock::now();
+            double frame_time = duration<double>(new_time - current_time).count();
+            current_time = new_time;
+            double now_ms = (double) SDL_GetTicks64();
+
+            int steps = timestep.advance(frame_time);
+            if (steps > 0) {
+                profile_scope_t scope(profiler, PHASE_UPDATE);
+                for (int i = 0; i < steps; i++) {
+                    // Krok i obejmuje czas gry kończący się (steps - 1 - i + alpha) kroków przed now_ms
+                    double tick_end = now_ms - (steps - 1 - i + timestep.alpha()) * dt * 1000.0;
+                    input.begin_tick(tick_end, apply_key);
+
+                    state.previous_player = state.player;
+                    const mapped_level_t *previous_map = current_map;
+                    current_map = levels->transition(state.player);
+                    state.map_index = levels->current_handle();
+                    bool was_on_ground = is_on_the_ground(state.player, *levels->current_collision());
+                    state.player = update_player(state.player, *levels->current_collision(), dt);
+                    state.tick++;
+                    state.trajectory = trajectory_hash(state.trajectory, state.player);
+
+                    // Dźwięki tylko zlecane - mieszanie odbywa się w wątku dźwięku
+                    if (audio) {
+                        if (current_map != previous_map) audio->play(SOUND_LEVEL);
+                        if (!was_on_ground && is_on_the_ground(state.player, *levels->current_collision())) {
+                            audio->play(SOUND_LAND);
+                        }
+                    }
 
-    while (still_playing) {
-        // Obsługa zdarzeń
-        SDL_Event event;
-        if (player.p.v.x >= current_map->width) {
-            current_map_index++;
-            if (current_map_index >= game_maps.size()) {
-                current_map_index = 0;
+                    // Po zmianie mapy lub teleportacji gracza nie interpolujemy
+                    double jump_x = state.player.p.v.x - state.previous_player.p.v.x;
+                    double jump_y = state.player.p.v.y - state.previous_player.p.v.y;
+                    if (current_map != previous_map || jump_x * jump_x + jump_y * jump_y > 1.0) {
+                        state.previous_player = state.player;
+                    }
+
+                    // Licznik kroków dla animacji gracza
+                    if (state.player_frame_counter >= 10) {
+                        state.player_texture1 = !state.player_texture1;
+                        state.player_frame_counter = 0;
+                    }
+                    state.player_frame_counter++;
+                    history.save(state);
+                }
+                sim_ticks.fetch_add(steps, std::memory_order_relaxed);
+
+                frame_snapshot_t &snapshot = snapshots.write_buffer();
+                snapshot.previous = state.previous_player;
+                snapshot.player = state.player;
+                snapshot.map = current_map;
+                snapshot.map_handle = state.map_index;
+                snapshot.player_texture1 = state.player_texture1 != 0;
+                snapshot.tick = state.tick;
+                snapshot.sequence = ++published;
+                snapshot.tick_time = new_time - duration_cast<steady_clock::duration>(
+                        duration<double>(timestep.alpha() * dt));
+                snapshots.publish();
             }
-            current_map = game_maps[current_map_index];
-            reset_player(player);
-        } else if (player.p.v.x < 0 && current_map != game_maps[0]) {
-            reset_player_to_previous_map(player, *current_map);
-        }else if (player.p.v.x < 0 && current_map == game_maps[0]) {
-            reset_player(player);
+
+            // Uśpienie do początku następnego kroku
+            std::this_thread::sleep_for(duration<double>((1.0 - timestep.alpha()) * dt));
         }
+    });
+
+    camera_t camera;
+
+    // Liczniki klatek okna i kroków symulacji, pokazywane w tytule okna co sekundę
+    long long rendered_frames = 0;
+    steady_clock::time_point start_time = steady_clock::now();
+    steady_clock::time_point rate_time = start_time;
+    long long rate_frames = 0, rate_ticks = 0;
+
+    // Obsługa zdarzeń; wywoływana na początku klatki i tuż przed
+    // SDL_RenderPresent, który z synchronizacją pionową blokuje wątek okna -
+    // krawędzie klawiszy docierają do symulacji o czas rysowania wcześniej
+    auto poll_events = [&] {
+        SDL_Event event;
         while (SDL_PollEvent(&event)) {
             switch (event.type) {
                 case SDL_QUIT:
                     still_playing = false;
                     break;
                 case SDL_KEYDOWN:
-                    if (is_on_the_ground(player, *current_map)) {
-                        if (event.key.keysym.scancode == SDL_SCANCODE_UP) player.a.v.y = -500;
-                        if (event.key.keysym.scancode == SDL_SCANCODE_LEFT) {
-                            player.a.v.x = -2;
-                            is_player_texture1 = false;
-                        }
-                        if (event.key.keysym.scancode == SDL_SCANCODE_RIGHT) {
-                            player.a.v.x = 2;
-                            is_player_texture1 = true;
+                case SDL_KEYUP: {
+                    bool pressed = event.type == SDL_KEYDOWN;
+                    if (!pressed && event.key.keysym.scancode == SDL_SCANCODE_Q) still_playing = false;
+                    if (!pressed && event.key.keysym.scancode == SDL_SCANCODE_BACKSPACE) {
+                        rewind_requests.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    if (!pressed && event.key.keysym.scancode == SDL_SCANCODE_F3) {
+                        profiler.overlay_visible = !profiler.overlay_visible;
+                    }
+                    if (!pressed && event.key.keysym.scancode == SDL_SCANCODE_F4) {
+                        const char *path = profile_path ? profile_path : "profile.csv";
+                        if (!profiler.write_csv(path)) {
+                            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't write profile to %s", path);
                         }
                     }
-                    break;
-                case SDL_KEYUP:
-                    if (event.key.keysym.scancode == SDL_SCANCODE_Q) still_playing = false;
-                    if (event.key.keysym.scancode == SDL_SCANCODE_R) reset_player(player);
-
 
-                    if (event.key.keysym.scancode == SDL_SCANCODE_UP) player.a.v.y = 0;
-                    if (event.key.keysym.scancode == SDL_SCANCODE_LEFT ||
-                        event.key.keysym.scancode == SDL_SCANCODE_RIGHT) {
-                        player.a.v.x = 0;
-                        player_frame_counter = 0;
-                    }
+                    // Klawisze sterujące trafiają do kroków fizyki przez input
+                    input.handle_event(event.key);
                     break;
+                }
+            }
+        }
+        input.sample_keyboard();
+    };
+
+    while (still_playing) {
+        {
+            profile_scope_t scope(profiler, PHASE_EVENTS);
+            poll_events();
+
+            // Zmienione pliki są dekodowane w tle (asset_loader_t, level_manager_t)
+            if (watcher && watcher->poll(changed_files)) {
+                for (const std::string &path : changed_files) {
+                    if (assets->reload(path) > 0 || levels->reload(path)) SDL_Log("Reloading %s", path.c_str());
+                }
             }
         }
 
-        // Aktualizacja fizyki gry
-        game_time += dt;
-        player = update_player(player, *current_map, dt);
+        // Najnowszy stan symulacji, interpolowany do bieżącej chwili
+        snapshots.update();
+        const frame_snapshot_t &snapshot = snapshots.read_buffer();
+        drawn_sequence.store(snapshot.sequence, std::memory_order_release);
+        double alpha = duration<double>(steady_clock::now() - snapshot.tick_time).count() / dt;
+        if (alpha > 1.0) alpha = 1.0;
+        if (alpha < 0.0) alpha = 0.0;
+        player_t drawn_player = interpolate_player(snapshot.previous, snapshot.player, alpha);
+
+        {
+            profile_scope_t scope(profiler, PHASE_UPLOAD);
+            assets->process_uploads(upload_budget_ms);
+        }
 
         // Renderowanie
-        SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
-        SDL_RenderClear(renderer);
-        SDL_RenderCopy(renderer, background_texture.get(), NULL, NULL);
-        draw_map(renderer, *current_map, tiles_texture);
-
-        SDL_Rect player_rect = {(int) (player.p.v.x * TILE_SIZE - (TILE_SIZE / 2)),
-                                (int) (player.p.v.y * TILE_SIZE - TILE_SIZE), TILE_SIZE / 2, TILE_SIZE};
-        SDL_Texture *current_player_texture = is_player_texture1 ? player_textures[0].get() : player_textures[1].get();
-        SDL_RenderCopyEx(renderer, current_player_texture, NULL, &player_rect, 0, NULL, SDL_FLIP_NONE);
-
-        SDL_RenderPresent(renderer);
-
-        // Opóźnienie w celu ograniczenia liczby klatek na sekundę
-        current_time = current_time + microseconds((long long int) (dt * 1000000.0));
-        std::this_thread::sleep_until(current_time);
-
-        // Licznik klatek dla animacji gracza
-        if (player_frame_counter >= 10) {
-            is_player_texture1 = !is_player_texture1;
-            player_frame_counter = 0;
+        {
+            profile_scope_t scope(profiler, PHASE_DRAW);
+            SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
+            SDL_RenderClear(renderer);
+            batch.begin(atlas->texture());
+
+            SDL_Rect viewport;
+            SDL_RenderGetViewport(renderer, &viewport);
+            batch.add(atlas->rect(IMAGE_BACKGROUND), {0, 0, (float) viewport.w, (float) viewport.h});
+
+            // Kamera śledzi środek postaci; rysowane są tylko widoczne kafelki
+            camera.width = viewport.w;
+            camera.height = viewport.h;
+            camera.follow(drawn_player.p.v.x, drawn_player.p.v.y - 0.5, snapshot.map->width, snapshot.map->height);
+            // Położenia kafelków są przesunięciami wewnątrz atlasu - bez niego ich nie ma
+            if (atlas->ready()) batch_map(batch, *snapshot.map, atlas->rect(IMAGE_BLOCK), camera);
+
+            SDL_FRect player_rect = {(float) ((int) (drawn_player.p.v.x * TILE_SIZE - (TILE_SIZE / 2)) - camera.x),
+                                     (float) ((int) (drawn_player.p.v.y * TILE_SIZE - TILE_SIZE) - camera.y),
+                                     TILE_SIZE / 2, TILE_SIZE};
+            batch.add(atlas->rect(snapshot.player_texture1 ? IMAGE_PLAYER : IMAGE_PLAYER2), player_rect);
+
+            if (batch.flush(renderer)) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't draw frame: %s", SDL_GetError());
+            }
+            profiler.draw_overlay(renderer);
+        }
+
+        {
+            profile_scope_t scope(profiler, PHASE_PRESENT);
+            poll_events();
+            SDL_RenderPresent(renderer);
         }
-        player_frame_counter++;
+        profiler.end_frame();
+        rendered_frames++;
+
+        steady_clock::time_point now = steady_clock::now();
+        double rate_seconds = duration<double>(now - rate_time).count();
+        if (rate_seconds >= 1.0) {
+            long long ticks = sim_ticks.load(std::memory_order_relaxed);
+            char title[96];
+            SDL_snprintf(title, sizeof(title), "mygame - render %.0f fps, simulation %.0f Hz",
+                         (rendered_frames - rate_frames) / rate_seconds, (ticks - rate_ticks) / rate_seconds);
+            SDL_SetWindowTitle(window, title);
+            rate_time = now;
+            rate_frames = rendered_frames;
+            rate_ticks = ticks;
+        }
+    }
+
+    simulating.store(false, std::memory_order_release);
+    simulation.join();
+
+    double seconds = duration<double>(steady_clock::now() - start_time).count();
+    if (seconds > 0) {
+        SDL_Log("Render %.1f fps, simulation %.1f Hz (%lld frames, %lld ticks, %lld dropped)",
+                rendered_frames / seconds, sim_ticks.load() / seconds, rendered_frames, sim_ticks.load(),
+                timestep.dropped_steps);
+    }
+    if (recorder) recorder->finish(state.tick, state.trajectory);
+    if (input.latency.count) {
+        SDL_Log("Input latency: %lld events, mean %.2f ms, max %.2f ms", input.latency.count, input.latency.mean_ms(),
+                input.latency.max_ms);
+    }
+    if (profile_path && !profiler.write_csv(profile_path)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't write profile to %s", profile_path);
     }
 
+    audio.reset();
+    // Tekstury muszą zostać zwolnione przed rendererem
+    atlas.reset();
+    assets.reset();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
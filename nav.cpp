@@ -0,0 +1,287 @@
+#include "nav.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+// Pole, na którym stoi gracz w pozycji (x, y) po wylądowaniu; stopy mogą
+// wystawać poza krawędź, więc sprawdzane są też kolumny krawędzi prostokąta
+static int landing_cell(const nav_graph_t &graph, const player_t &player) {
+    int row = floor_to_int(player.p.v.y + 0.01);
+    int c = graph.cell(floor_to_int(player.p.v.x), row);
+    if (c < 0) c = graph.cell(floor_to_int(player.p.v.x - player_box.half_width), row);
+    if (c < 0) c = graph.cell(floor_to_int(player.p.v.x + player_box.half_width - 1e-9), row);
+    return c;
+}
+
+nav_graph_t::nav_graph_t(const packed_map_t &map, double dt) : width(map.width), height(map.height) {
+    // Pola: pełny kafelek z pustym nad nim; kolejne pola platformy mają kolejne numery
+    cell_of_tile.assign((size_t) width * height, -1);
+    for (int row = 1; row < height; row++) {
+        for (int x = 0; x < width; x++) {
+            if (map.get(x, row) <= 0 || map.get(x, row - 1) > 0) continue;
+            if (x == 0 || cell(x - 1, row) < 0) spans_.push_back({(int16_t) row, (int16_t) x, (int16_t) x});
+            spans_.back().x1 = (int16_t) x;
+            cell_of_tile[(size_t) row * width + x] = (int32_t) cell_x.size();
+            cell_x.push_back((int16_t) x);
+            cell_row_.push_back((int16_t) row);
+            cell_span_.push_back((int32_t) spans_.size() - 1);
+        }
+    }
+
+    // Koszt marszu: czas przejścia 16 kafelków od startu z miejsca na płaskiej podłodze
+    game_map_t flat = {20, 3, std::vector<int>(60, 0)};
+    for (int x = 0; x < flat.width; x++) flat.map[2 * flat.width + x] = 1;
+    const packed_map_t flat_map(flat);
+    player_t walker = {{1.5, 2}, {0, 0}, {2, 0}};
+    int walk_ticks = 0;
+    while (walker.p.v.x < 17.5 && walk_ticks < 10000) {
+        walker = update_player(walker, flat_map, dt);
+        walk_ticks++;
+    }
+    walk_cost = (uint16_t) std::max(1, walk_ticks / 16);
+    min_cost_per_column = walk_cost;
+
+    // Skoki z każdego pola, spadnięcia z krawędzi platform
+    link_first.resize(cell_x.size() + 1);
+    std::vector<nav_link_t> out;
+    for (int c = 0; c < cell_count(); c++) {
+        link_first[c] = (int32_t) links.size();
+        out.clear();
+        for (int dir = -1; dir <= 1; dir++) add_flight(map, dt, c, NAV_JUMP, dir, out);
+        const nav_span_t &span = spans_[cell_span_[c]];
+        if (cell_x[c] == span.x0) add_flight(map, dt, c, NAV_FALL, -1, out);
+        if (cell_x[c] == span.x1) add_flight(map, dt, c, NAV_FALL, 1, out);
+
+        // Do jednego pola wystarcza najtańsze przejście
+        std::sort(out.begin(), out.end(), [](const nav_link_t &a, const nav_link_t &b) {
+            return a.target != b.target ? a.target < b.target : a.cost < b.cost;
+        });
+        for (size_t i = 0; i < out.size(); i++) {
+            if (i > 0 && out[i].target == out[i - 1].target) continue;
+            links.push_back(out[i]);
+            int dx = std::abs(cell_x[out[i].target] - cell_x[c]);
+            if (dx > 0) min_cost_per_column = std::min<uint32_t>(min_cost_per_column, out[i].cost / dx);
+        }
+    }
+    link_first[cell_x.size()] = (int32_t) links.size();
+}
+
+void nav_graph_t::add_flight(const packed_map_t &map, double dt, int from, nav_action_t action, int dir,
+                             std::vector<nav_link_t> &out) const {
+    player_t player = {{cell_x[from] + 0.5, (double) cell_row_[from]},
+                       {0, 0},
+                       {2.0 * dir, action == NAV_JUMP ? -500.0 : 0.0}};
+    bool airborne = false;
+    for (int tick = 1; tick <= NAV_MAX_FLIGHT_TICKS; tick++) {
+        player_t previous = player;
+        player = update_player(player, map, dt);
+        // Spadnięcie poniżej mapy (reset gracza) albo wyjście za krawędź poziomu
+        if (player.p.v.y < previous.p.v.y - 1.0 || player.p.v.x < 0 || player.p.v.x >= width) return;
+        if (action == NAV_JUMP && tick == 1) player.a.v.y = 0; // strzałka puszczona po odbiciu
+
+        if (!is_on_the_ground(player, map)) {
+            airborne = true;
+            continue;
+        }
+        // Zejście z krawędzi zaczyna się marszem po platformie
+        if (!airborne) {
+            if (action == NAV_FALL && tick < 120) continue;
+            return;
+        }
+        int to = landing_cell(*this, player);
+        if (to >= 0 && cell_span_[to] != cell_span_[from]) {
+            out.push_back({to, (uint16_t) tick, (int8_t) dir, (uint8_t) action});
+        }
+        return;
+    }
+}
+
+int nav_graph_t::cell_at(double x, double y, int max_drop) const {
+    int col = floor_to_int(x);
+    int row = floor_to_int(y + 0.01);
+    for (int r = row; r <= row + max_drop && r < height; r++) {
+        int c = cell(col, r);
+        if (c < 0) c = cell(floor_to_int(x - player_box.half_width), r);
+        if (c < 0) c = cell(floor_to_int(x + player_box.half_width - 1e-9), r);
+        if (c >= 0) return c;
+    }
+    return -1;
+}
+
+size_t nav_graph_t::memory_bytes() const {
+    return cell_of_tile.size() * sizeof(int32_t) + cell_x.size() * (2 * sizeof(int16_t) + sizeof(int32_t)) +
+           spans_.size() * sizeof(nav_span_t) + link_first.size() * sizeof(int32_t) +
+           links.size() * sizeof(nav_link_t);
+}
+
+void nav_query_t::prepare(const nav_graph_t &graph) {
+    size_t n = (size_t) graph.cell_count();
+    if (stamp.size() < n) {
+        stamp.resize(n, 0);
+        g.resize(n);
+        parent.resize(n);
+        parent_action.resize(n);
+        parent_dir.resize(n);
+        closed.resize(n);
+    }
+    // Każde wstawienie do kopca to poprawa kosztu przez krawędź: najwyżej
+    // dwie krawędzie marszu na pole plus przejścia
+    size_t pushes = 2 * n + graph.links.size() + 1;
+    if (heap.capacity() < pushes) heap.reserve(pushes);
+    if (path_.capacity() < n) path_.reserve(n);
+
+    if (++generation == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        generation = 1;
+    }
+}
+
+bool nav_query_t::find_path(const nav_graph_t &graph, int from, int to) {
+    path_.clear();
+    heap.clear();
+    cost = 0;
+    expanded = 0;
+    if (from < 0 || to < 0 || from >= graph.cell_count() || to >= graph.cell_count()) return false;
+    prepare(graph);
+
+    const int goal_x = graph.cell_x[to];
+    const uint32_t h_rate = graph.min_cost_per_column;
+    auto relax = [&](int c, int n, uint32_t step_cost, uint8_t action, int8_t dir) {
+        if (stamp[n] != generation) {
+            stamp[n] = generation;
+            closed[n] = 0;
+            g[n] = UINT32_MAX;
+        }
+        uint32_t cost_n = g[c] + step_cost;
+        if (closed[n] || cost_n >= g[n]) return;
+        g[n] = cost_n;
+        parent[n] = c;
+        parent_action[n] = action;
+        parent_dir[n] = dir;
+        uint32_t f = cost_n + (uint32_t) std::abs(graph.cell_x[n] - goal_x) * h_rate;
+        heap.push_back((uint64_t) f << 32 | (uint32_t) n);
+        std::push_heap(heap.begin(), heap.end(), std::greater<uint64_t>());
+    };
+
+    stamp[from] = generation;
+    closed[from] = 0;
+    g[from] = 0;
+    parent[from] = -1;
+    heap.push_back((uint64_t) (std::abs(graph.cell_x[from] - goal_x) * h_rate) << 32 | (uint32_t) from);
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<uint64_t>());
+        int c = (int) (uint32_t) heap.back();
+        heap.pop_back();
+        if (closed[c]) continue; // nieaktualny wpis (pole osiągnięte później taniej)
+        closed[c] = 1;
+        expanded++;
+
+        if (c == to) {
+            cost = g[c];
+            for (int s = c; s >= 0; s = parent[s]) {
+                path_.push_back({graph.cell_x[s], graph.cell_row_[s], s == from ? (uint8_t) NAV_START : parent_action[s],
+                                 s == from ? (int8_t) 0 : parent_dir[s]});
+            }
+            std::reverse(path_.begin(), path_.end());
+            return true;
+        }
+
+        // Pola jednej platformy mają kolejne numery
+        const int span = graph.cell_span_[c];
+        if (c > 0 && graph.cell_span_[c - 1] == span) relax(c, c - 1, graph.walk_cost, NAV_WALK, -1);
+        if (c + 1 < graph.cell_count() && graph.cell_span_[c + 1] == span) relax(c, c + 1, graph.walk_cost, NAV_WALK, 1);
+        for (int32_t l = graph.link_first[c]; l < graph.link_first[c + 1]; l++) {
+            const nav_link_t &link = graph.links[l];
+            relax(c, link.target, link.cost, link.action, link.dir);
+        }
+    }
+    return false;
+}
+
+// Zatrzymanie agenta na ziemi w x = target_x: klawisz w stronę celu, a gdy
+// droga hamowania (v^2 / 2a przy a = 2) sięga celu - klawisz przeciwny.
+// Zwraca true, gdy agent stoi u celu.
+static bool settle(player_t &agent, const packed_map_t &map, double target_x) {
+    const double dx = target_x - agent.p.v.x, v = agent.v.v.x;
+    if (std::fabs(dx) < 0.15 && std::fabs(v) < 0.3) {
+        apply_input(agent, map, INPUT_KEY_LEFT, false);
+        return true;
+    }
+    bool brake = v * dx < 0 || v * v / 4 >= std::fabs(dx) || std::fabs(dx) < 0.15;
+    double push = brake ? -v : dx;
+    apply_input(agent, map, push < 0 ? INPUT_KEY_LEFT : INPUT_KEY_RIGHT, true);
+    return false;
+}
+
+void nav_steer(player_t &agent, const packed_map_t &map, const nav_graph_t &graph, int current,
+               const nav_step_t &next) {
+    const double target_x = next.x + 0.5;
+    if (!is_on_the_ground(agent, map)) {
+        // W powietrzu klawisze można tylko puścić (apply_input odrzuca
+        // wciśnięcia): strzałka po odbiciu, kierunek, gdy lot przeniósłby
+        // agenta za cel
+        if (agent.a.v.y != 0) apply_input(agent, map, INPUT_KEY_UP, false);
+        double landing = agent.p.v.x + agent.v.v.x * 0.25;
+        if (agent.a.v.x != 0 && (target_x - landing) * agent.a.v.x < 0) apply_input(agent, map, INPUT_KEY_LEFT, false);
+        return;
+    }
+
+    const int here = graph.cell_at(agent.p.v.x, agent.p.v.y, 0);
+    if (next.action == NAV_JUMP || next.action == NAV_FALL) {
+        // Skoki grafu zaczynają się w spoczynku na środku pola - z rozpędu
+        // agent przeleciałby nad polem docelowym albo uderzył w sufit
+        if (here == current && next.action == NAV_JUMP && !settle(agent, map, graph.cell_column(current) + 0.5)) {
+            return;
+        }
+        // Zejście z krawędzi: nie szybciej niż marsz od środka pola ze
+        // spoczynku (v^2 = 2ad), inaczej najpierw zatrzymanie na środku
+        if (here == current && next.action == NAV_FALL) {
+            double center = graph.cell_column(current) + 0.5;
+            double walked = (agent.p.v.x - center) * next.dir;
+            double v = agent.v.v.x * next.dir;
+            bool walking_off = agent.a.v.x * next.dir > 0 && walked > -0.15 && v >= 0 &&
+                               v <= std::sqrt(4.0 * std::max(walked, 0.0)) + 0.3;
+            if (!walking_off && !settle(agent, map, center)) return;
+        }
+        if (here == current) {
+            if (next.action == NAV_JUMP) apply_input(agent, map, INPUT_KEY_UP, true);
+            if (next.dir != 0) apply_input(agent, map, next.dir < 0 ? INPUT_KEY_LEFT : INPUT_KEY_RIGHT, true);
+            else apply_input(agent, map, INPUT_KEY_LEFT, false);
+            return;
+        }
+        // Najpierw dojście na pole, z którego zaczyna się przejście
+        double start_x = graph.cell_column(current) + 0.5;
+        apply_input(agent, map, start_x < agent.p.v.x ? INPUT_KEY_LEFT : INPUT_KEY_RIGHT, true);
+        return;
+    }
+
+    // Marsz najwyżej z prędkością NAV_WALK_SPEED, żeby przed skokiem dało się
+    // wyhamować na jednym kafelku
+    double dx = target_x - agent.p.v.x;
+    bool too_fast = agent.v.v.x * dx > 0 && std::fabs(agent.v.v.x) > NAV_WALK_SPEED;
+    if ((dx > -0.1 && dx < 0.1) || too_fast) apply_input(agent, map, INPUT_KEY_LEFT, false);
+    else apply_input(agent, map, dx < 0 ? INPUT_KEY_LEFT : INPUT_KEY_RIGHT, true);
+}
+
+bool nav_agent_t::control(player_t &agent, const packed_map_t &map, const nav_graph_t &graph, nav_query_t &query,
+                          int goal) {
+    if (is_on_the_ground(agent, map)) {
+        int here = graph.cell_at(agent.p.v.x, agent.p.v.y, 0);
+        if (here == goal) {
+            next.action = NAV_START;
+            return true;
+        }
+        if (here >= 0 && (here != current || next.action == NAV_START)) {
+            current = here;
+            replans++;
+            if (!query.find_path(graph, current, goal) || query.path().size() < 2) {
+                next.action = NAV_START;
+                return false;
+            }
+            next = query.path()[1];
+        }
+    }
+    if (next.action != NAV_START) nav_steer(agent, map, graph, current, next);
+    return true;
+}
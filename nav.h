@@ -0,0 +1,148 @@
+#ifndef MYGAME_NAV_H
+#define MYGAME_NAV_H
+
+#include "game.h"
+#include "packed_map.h"
+#include <cstdint>
+#include <vector>
+
+// Najdłuższy lot (skok lub spadanie) brany pod uwagę przy budowie grafu
+#define NAV_MAX_FLIGHT_TICKS 600
+
+// Najwyższa prędkość marszu agenta (kafelki na sekundę); z niej agent
+// hamuje przed skokiem na drodze ~1 kafelka
+#define NAV_WALK_SPEED 2.0
+
+// Sposób przejścia do kolejnego pola ścieżki
+enum nav_action_t : uint8_t {
+    NAV_START = 0, // pole początkowe ścieżki
+    NAV_WALK = 1,  // krok do sąsiedniego pola tej samej platformy
+    NAV_JUMP = 2,  // skok (strzałka w górę) z kierunkiem dir
+    NAV_FALL = 3,  // zejście z krawędzi platformy w kierunku dir
+};
+
+// Platforma: pola row, x0..x1 (włącznie) - ciąg kafelków, na których można
+// stanąć (pełny kafelek w wierszu row, pusty nad nim)
+struct nav_span_t {
+    int16_t row, x0, x1;
+};
+
+// Przejście skokiem lub spadnięciem z pola do pola target
+struct nav_link_t {
+    int32_t target;
+    uint16_t cost; // czas lotu w krokach fizyki
+    int8_t dir;    // klawisz kierunku trzymany w locie: -1 lewo, 0 brak, 1 prawo
+    uint8_t action;
+};
+
+// Pole ścieżki: kafelek, na którym stoi agent (x, row - wiersz pod stopami)
+// i sposób, w jaki na nie dotarł z poprzedniego pola
+struct nav_step_t {
+    int16_t x, row;
+    uint8_t action;
+    int8_t dir;
+};
+
+// Graf nawigacji poziomu: pola, na których można stanąć, pogrupowane
+// w platformy, oraz przejścia między nimi. Skoki i spadnięcia są wyznaczane
+// symulacją tej samej fizyki co gracz (update_player: grawitacja 10, skok
+// -500, tarcie 0.99, kolizje sweep_aabb) startującej ze środka pola, z
+// klawiszem kierunku trzymanym przez cały lot. Koszty są w krokach fizyki.
+//
+// Budowa jest kosztowna (symulacja lotu z każdego pola), więc robi się ją
+// raz przy wczytaniu poziomu; zapytania (nav_query_t) tylko czytają graf
+// i mogą działać z wielu wątków naraz.
+class nav_graph_t {
+public:
+    int width = 0, height = 0;
+    uint16_t walk_cost = 1; // kroki fizyki na przejście jednego kafelka
+
+    nav_graph_t() = default;
+    explicit nav_graph_t(const packed_map_t &map, double dt = 1.0 / 60.0);
+
+    int cell_count() const { return (int) cell_x.size(); }
+
+    // Pole dla kafelka x w wierszu row albo -1
+    int cell(int x, int row) const {
+        if (x < 0 || x >= width || row < 0 || row >= height) return -1;
+        return cell_of_tile[(size_t) row * width + x];
+    }
+
+    // Pole pod pozycją (x, y) stóp gracza: kafelek pod stopami albo, gdy
+    // gracz jest w powietrzu, najbliższe pole do max_drop wierszy niżej; -1, gdy brak
+    int cell_at(double x, double y, int max_drop = 4) const;
+
+    int cell_column(int c) const { return cell_x[c]; }
+    int cell_row(int c) const { return cell_row_[c]; }
+    int cell_span(int c) const { return cell_span_[c]; }
+
+    const std::vector<nav_span_t> &spans() const { return spans_; }
+    size_t link_count() const { return links.size(); }
+    size_t memory_bytes() const;
+
+private:
+    friend class nav_query_t;
+
+    std::vector<int32_t> cell_of_tile; // width * height, -1 - nie da się stanąć
+    std::vector<int16_t> cell_x, cell_row_;
+    std::vector<int32_t> cell_span_;
+    std::vector<nav_span_t> spans_;
+    std::vector<int32_t> link_first; // przejścia pola c: links[link_first[c] .. link_first[c + 1])
+    std::vector<nav_link_t> links;
+    uint32_t min_cost_per_column = 1; // dolne ograniczenie kosztu przesunięcia o kafelek (heurystyka A*)
+
+    void add_flight(const packed_map_t &map, double dt, int from, nav_action_t action, int dir,
+                    std::vector<nav_link_t> &out) const;
+};
+
+// Kontekst zapytań A* do wielokrotnego użycia. Tablice stanu mają rozmiar
+// liczby pól największego dotąd grafu i są unieważniane numerem zapytania
+// zamiast czyszczenia, a kopiec i ścieżka mają zarezerwowaną pojemność, więc
+// po pierwszym zapytaniu dla danego grafu find_path nie alokuje pamięci.
+// Jeden kontekst na wątek.
+class nav_query_t {
+public:
+    // Szuka najtańszej ścieżki z pola from do pola to. Zwraca false, gdy
+    // ścieżki nie ma (albo pola są niepoprawne); wtedy path() jest pusta.
+    bool find_path(const nav_graph_t &graph, int from, int to);
+
+    // Ścieżka ostatniego find_path: od pola from (NAV_START) do pola to
+    const std::vector<nav_step_t> &path() const { return path_; }
+    uint32_t path_cost() const { return cost; }
+
+    int expanded = 0; // pola rozwinięte w ostatnim zapytaniu
+
+private:
+    std::vector<uint32_t> stamp;   // numer zapytania, w którym pole zostało osiągnięte
+    std::vector<uint32_t> g;       // koszt dojścia
+    std::vector<int32_t> parent;
+    std::vector<uint8_t> parent_action;
+    std::vector<int8_t> parent_dir;
+    std::vector<uint8_t> closed;   // 1 - rozwinięte (ważne dla stamp == generation)
+    std::vector<uint64_t> heap;    // f << 32 | pole, kopiec minimalny
+    std::vector<nav_step_t> path_;
+    uint32_t generation = 0;
+    uint32_t cost = 0;
+
+    void prepare(const nav_graph_t &graph);
+};
+
+// Sterowanie agentem idącym po ścieżce: ustawia przyspieszenie gracza tak
+// jak klawisze (apply_input) dla kroku ścieżki next, do którego agent
+// zmierza z pola current. W locie agent skręca w stronę środka pola docelowego.
+void nav_steer(player_t &agent, const packed_map_t &map, const nav_graph_t &graph, int current,
+               const nav_step_t &next);
+
+// Agent idący do pola goal: po każdym lądowaniu na nowym polu planuje
+// ścieżkę od nowa (nav_query_t) i steruje w stronę jej pierwszego kroku
+struct nav_agent_t {
+    int current = -1;                         // pole, z którego wyznaczono ścieżkę
+    nav_step_t next = {0, 0, NAV_START, 0};   // krok, do którego agent zmierza
+    long long replans = 0;
+
+    // Sterowanie na jeden krok fizyki (przed update_player). Zwraca false,
+    // gdy agent stoi na polu bez ścieżki do celu; na polu goal nic nie robi.
+    bool control(player_t &agent, const packed_map_t &map, const nav_graph_t &graph, nav_query_t &query, int goal);
+};
+
+#endif
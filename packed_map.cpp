@@ -0,0 +1,105 @@
+#include "packed_map.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+static int count_trailing_zeros(uint64_t v) {
+    unsigned long i;
+    _BitScanForward64(&i, v);
+    return (int) i;
+}
+static int count_leading_zeros(uint64_t v) {
+    unsigned long i;
+    _BitScanReverse64(&i, v);
+    return 63 - (int) i;
+}
+#else
+static int count_trailing_zeros(uint64_t v) {
+    return __builtin_ctzll(v);
+}
+static int count_leading_zeros(uint64_t v) {
+    return __builtin_clzll(v);
+}
+#endif
+
+void packed_map_t::resize(int new_width, int new_height) {
+    width = new_width;
+    height = new_height;
+    tile_stride = width + 2;
+    // Słowo ramki po lewej, kafelki 0..width-1 i co najmniej jeden bit ramki po prawej
+    row_words = (width + 64 + 1 + 63) / 64;
+    tiles.assign((size_t) tile_stride * (height + 2), 1);
+    collision.assign((size_t) row_words * (height + 2), ~0ULL);
+    revision++;
+}
+
+void packed_map_t::set(int x, int y, int tile) {
+    if (x < 0 || x >= width || y < 0 || y >= height) return;
+    tiles[(y + 1) * tile_stride + x + 1] = (uint8_t) tile;
+    uint64_t &word = collision[(size_t) (y + 1) * row_words + ((x + 64) >> 6)];
+    uint64_t mask = 1ULL << ((x + 64) & 63);
+    word = tile > 0 ? word | mask : word & ~mask;
+    revision++;
+}
+
+bool packed_map_t::any_solid_in_span(int x0, int x1, int y) const {
+    if (x0 > x1) return false;
+    const uint64_t *r = row(clamp_y(y));
+    unsigned b0 = (unsigned) (clamp_x(x0) + 64);
+    unsigned b1 = (unsigned) (clamp_x(x1) + 64);
+    unsigned w0 = b0 >> 6, w1 = b1 >> 6;
+    uint64_t first_mask = ~0ULL << (b0 & 63);
+    uint64_t last_mask = ~0ULL >> (63 - (b1 & 63));
+    if (w0 == w1) return (r[w0] & first_mask & last_mask) != 0;
+
+    uint64_t bits = (r[w0] & first_mask) | (r[w1] & last_mask);
+    for (unsigned w = w0 + 1; w < w1; w++) bits |= r[w];
+    return bits != 0;
+}
+
+int packed_map_t::first_solid_in_span(int x0, int x1, int y) const {
+    if (x0 > x1) return x1 + 1;
+    // Kafelek poza mapą jest pełny; dalej x0 leży w mapie, a przycięty
+    // koniec x1 trafia na pełną ramkę, która jest też poprawnym wynikiem
+    if (x0 < 0 || x0 >= width || y < 0 || y >= height) return x0;
+    const uint64_t *r = row(y);
+    unsigned b0 = (unsigned) (x0 + 64);
+    unsigned b1 = (unsigned) (clamp_x(x1) + 64);
+    unsigned w0 = b0 >> 6, w1 = b1 >> 6;
+    for (unsigned w = w0; w <= w1; w++) {
+        uint64_t bits = r[w];
+        if (w == w0) bits &= ~0ULL << (b0 & 63);
+        if (w == w1) bits &= ~0ULL >> (63 - (b1 & 63));
+        if (bits) {
+            return (int) (w * 64 + count_trailing_zeros(bits)) - 64;
+        }
+    }
+    return x1 + 1;
+}
+
+int packed_map_t::last_solid_in_span(int x0, int x1, int y) const {
+    if (x0 > x1) return x0 - 1;
+    if (x1 < 0 || x1 >= width || y < 0 || y >= height) return x1;
+    const uint64_t *r = row(y);
+    unsigned b0 = (unsigned) (clamp_x(x0) + 64);
+    unsigned b1 = (unsigned) (x1 + 64);
+    unsigned w0 = b0 >> 6, w1 = b1 >> 6;
+    for (unsigned w = w1 + 1; w-- > w0;) {
+        uint64_t bits = r[w];
+        if (w == w0) bits &= ~0ULL << (b0 & 63);
+        if (w == w1) bits &= ~0ULL >> (63 - (b1 & 63));
+        if (bits) {
+            return (int) (w * 64 + 63 - count_leading_zeros(bits)) - 64;
+        }
+    }
+    return x0 - 1;
+}
+
+bool packed_map_t::any_solid_in_rect(int x0, int y0, int x1, int y1) const {
+    if (y0 > y1) return false;
+    // Wiersze poza mapą są w całości pełne
+    if (y0 < 0 || y1 >= height) return x0 <= x1;
+    for (int y = y0; y <= y1; y++) {
+        if (any_solid_in_span(x0, x1, y)) return true;
+    }
+    return false;
+}
@@ -0,0 +1,85 @@
+#ifndef MYGAME_PACKED_MAP_H
+#define MYGAME_PACKED_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Zwarta postać mapy do testów kolizji: id kafelków jako uint8_t oraz
+// warstwa kolizji 1 bit na kafelek. Obie warstwy mają ramkę z pełnych
+// kafelków, a współrzędne są przycinane do ramki (min/max bez skoków), więc
+// zapytania nie mają gałęzi sprawdzających granice - wszystko poza mapą
+// i tak jest pełne, tak jak w game_map_t::get.
+//
+// Wiersz warstwy kolizji zaczyna się jednym słowem ramki (64 bity), więc
+// kafelek x leży na bicie x + 64, a kafelek -1 na bicie 63.
+class packed_map_t {
+public:
+    int width, height;
+    unsigned revision = 0;
+
+    packed_map_t() : width(0), height(0), tile_stride(0), row_words(0) {}
+
+    // Buduje mapę z dowolnej mapy z polami width, height i metodą get(x, y);
+    // kafelek jest pełny, gdy get(x, y) > 0 (jak w is_in_collision)
+    template<class map_t>
+    explicit packed_map_t(const map_t &map) {
+        resize(map.width, map.height);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                set(x, y, map.get(x, y));
+            }
+        }
+        revision = 0;
+    }
+
+    int get(int x, int y) const {
+        return tiles[(clamp_y(y) + 1) * tile_stride + clamp_x(x) + 1];
+    }
+
+    bool solid(int x, int y) const {
+        unsigned bit = (unsigned) (clamp_x(x) + 64);
+        return (row(clamp_y(y))[bit >> 6] >> (bit & 63)) & 1;
+    }
+
+    // Czy w wierszu y jest pełny kafelek w przedziale x0..x1 (włącznie).
+    // Liczone słowami po 64 kafelki: maska pierwszego i ostatniego słowa
+    // oraz OR słów pomiędzy.
+    bool any_solid_in_span(int x0, int x1, int y) const;
+
+    // Pierwszy pełny kafelek w wierszu y w przedziale x0..x1 (od lewej)
+    // albo x1 + 1, gdy takiego nie ma
+    int first_solid_in_span(int x0, int x1, int y) const;
+
+    // Ostatni pełny kafelek w wierszu y w przedziale x0..x1 (od prawej)
+    // albo x0 - 1, gdy takiego nie ma
+    int last_solid_in_span(int x0, int x1, int y) const;
+
+    // Czy prostokąt kafelków x0..x1, y0..y1 zawiera pełny kafelek
+    bool any_solid_in_rect(int x0, int y0, int x1, int y1) const;
+
+    void resize(int width, int height);
+    void set(int x, int y, int tile);
+
+private:
+    int clamp_x(int x) const {
+        x = x < -1 ? -1 : x;
+        return x > width ? width : x;
+    }
+
+    int clamp_y(int y) const {
+        y = y < -1 ? -1 : y;
+        return y > height ? height : y;
+    }
+
+    const uint64_t *row(int y) const {
+        return &collision[(size_t) (y + 1) * row_words];
+    }
+
+    int tile_stride;
+    int row_words;
+    std::vector<uint8_t> tiles;      // (width + 2) * (height + 2), ramka = 1
+    std::vector<uint64_t> collision; // (height + 2) wierszy po row_words słów
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "profiler.h"
+
+#if MYGAME_PROFILER
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+// Czcionka 3x5: bit (wiersz * 3 + kolumna) zapala piksel
+static const char FONT_CHARS[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ.:%/-_";
+static const Uint16 FONT_GLYPHS[] = {
+        0x7b6f, 0x749a, 0x73e7, 0x79a7, 0x49ed, 0x79cf, 0x7bcf, 0x24a7, 0x7bef, 0x79ef,
+        0x5bea, 0x3aeb, 0x624e, 0x3b6b, 0x72cf, 0x12cf, 0x6b4e, 0x5bed, 0x7497, 0x2b24,
+        0x5aed, 0x7249, 0x5bfd, 0x5b6b, 0x2b6a, 0x12eb, 0x676a, 0x5aeb, 0x388e, 0x2497,
+        0x7b6d, 0x2b6d, 0x5fed, 0x5aad, 0x24ad, 0x72a7, 0x2000, 0x0410, 0x52a5, 0x12a4,
+        0x01c0, 0x7000};
+
+#define OVERLAY_SCALE 2                     // rozmiar piksela czcionki
+#define OVERLAY_GRAPH_FRAMES 240            // liczba klatek na wykresie
+#define OVERLAY_GRAPH_HEIGHT 100            // wysokość wykresu w pikselach
+#define OVERLAY_GRAPH_MS (1000.0 / 30.0)    // czas odpowiadający pełnej wysokości wykresu
+
+// Kolory faz na wykresie
+static const SDL_Color PHASE_COLORS[PROFILER_MAX_PHASES] = {
+        {0x4c, 0xaf, 0x50, 0xff}, {0x21, 0x96, 0xf3, 0xff}, {0xff, 0x98, 0x00, 0xff}, {0xe9, 0x1e, 0x63, 0xff},
+        {0x9c, 0x27, 0xb0, 0xff}, {0x00, 0xbc, 0xd4, 0xff}, {0xff, 0xeb, 0x3b, 0xff}, {0x79, 0x55, 0x48, 0xff}};
+
+profiler_t::profiler_t(const char *const *phase_names, int count)
+        : names(phase_names), phase_count(std::min(count, PROFILER_MAX_PHASES)),
+          ms_per_tick(1000.0 / (double) SDL_GetPerformanceFrequency()), frame_start(SDL_GetPerformanceCounter()) {
+    for (std::atomic<Uint64> &a : accumulated) a.store(0);
+    std::memset(frames, 0, sizeof(frames));
+    rects.reserve(OVERLAY_GRAPH_FRAMES * PROFILER_MAX_PHASES);
+    samples.reserve(PROFILER_FRAMES);
+    stacked.reserve(OVERLAY_GRAPH_FRAMES);
+}
+
+void profiler_t::end_frame() {
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 n = frame_count.load(std::memory_order_relaxed);
+    frame_t &frame = frames[n % PROFILER_FRAMES];
+    for (int p = 0; p < PROFILER_MAX_PHASES; p++) {
+        frame.phase_ticks[p] = accumulated[p].exchange(0, std::memory_order_relaxed);
+    }
+    frame.frame_ticks = now - frame_start;
+    frame_start = now;
+    frame_count.store(n + 1, std::memory_order_release);
+}
+
+void profiler_t::draw_text(int x, int y, const char *text) {
+    for (; *text; text++, x += 4 * OVERLAY_SCALE) {
+        const char *found = std::strchr(FONT_CHARS, *text);
+        if (*text == ' ' || !found) continue;
+        Uint16 glyph = FONT_GLYPHS[found - FONT_CHARS];
+        for (int bit = 0; bit < 15; bit++) {
+            if (glyph & (1 << bit)) {
+                rects.push_back({x + bit % 3 * OVERLAY_SCALE, y + bit / 3 * OVERLAY_SCALE, OVERLAY_SCALE, OVERLAY_SCALE});
+            }
+        }
+    }
+}
+
+void profiler_t::draw_overlay(SDL_Renderer *renderer) {
+    if (!overlay_visible) return;
+    Uint64 n = frame_count.load(std::memory_order_acquire);
+    int available = (int) std::min<Uint64>(n, PROFILER_FRAMES);
+
+    const int x0 = 8, y0 = 8;
+    const int line = 7 * OVERLAY_SCALE;
+    const int panel_w = std::max(OVERLAY_GRAPH_FRAMES, 40 * 4 * OVERLAY_SCALE) + 16;
+    const int panel_h = OVERLAY_GRAPH_HEIGHT + (phase_count + 2) * line + 24;
+
+    SDL_BlendMode saved_blend;
+    Uint8 saved[4];
+    SDL_GetRenderDrawBlendMode(renderer, &saved_blend);
+    SDL_GetRenderDrawColor(renderer, &saved[0], &saved[1], &saved[2], &saved[3]);
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0xb0);
+    SDL_Rect panel = {x0, y0, panel_w, panel_h};
+    SDL_RenderFillRect(renderer, &panel);
+
+    // Wykres: słupki ostatnich klatek, fazy ułożone jedna na drugiej
+    const int graph_x = x0 + 8, graph_bottom = y0 + 8 + OVERLAY_GRAPH_HEIGHT;
+    const double px_per_ms = OVERLAY_GRAPH_HEIGHT / OVERLAY_GRAPH_MS;
+    int shown = std::min(available, OVERLAY_GRAPH_FRAMES);
+    stacked.assign((size_t) shown, 0);
+    for (int p = 0; p < phase_count; p++) {
+        rects.clear();
+        for (int i = 0; i < shown; i++) {
+            const frame_t &frame = frames[(n - shown + i) % PROFILER_FRAMES];
+            int h = (int) (frame.phase_ticks[p] * ms_per_tick * px_per_ms + 0.5);
+            if (stacked[i] + h > OVERLAY_GRAPH_HEIGHT) h = OVERLAY_GRAPH_HEIGHT - stacked[i];
+            if (h <= 0) continue;
+            stacked[i] += h;
+            rects.push_back({graph_x + i, graph_bottom - stacked[i], 1, h});
+        }
+        SDL_SetRenderDrawColor(renderer, PHASE_COLORS[p].r, PHASE_COLORS[p].g, PHASE_COLORS[p].b, 0xff);
+        if (!rects.empty()) SDL_RenderFillRects(renderer, rects.data(), (int) rects.size());
+    }
+
+    // Czas całej klatki jako linia nad słupkami faz, linia 60 Hz jako odniesienie
+    rects.clear();
+    for (int i = 0; i < shown; i++) {
+        const frame_t &frame = frames[(n - shown + i) % PROFILER_FRAMES];
+        int h = std::min((int) (frame.frame_ticks * ms_per_tick * px_per_ms + 0.5), OVERLAY_GRAPH_HEIGHT);
+        rects.push_back({graph_x + i, graph_bottom - h, 1, 1});
+    }
+    rects.push_back({graph_x, graph_bottom - (int) (1000.0 / 60.0 * px_per_ms), OVERLAY_GRAPH_FRAMES, 1});
+    SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
+    SDL_RenderFillRects(renderer, rects.data(), (int) rects.size());
+
+    // Tabela percentyli ze wszystkich klatek w pierścieniu
+    rects.clear();
+    int y = graph_bottom + 8;
+    char text[96];
+    draw_text(graph_x, y, "PHASE        P50 MS   P99 MS   MAX MS");
+    y += line;
+    for (int p = 0; p <= phase_count; p++) {
+        samples.clear();
+        for (int i = 0; i < available; i++) {
+            const frame_t &frame = frames[(n - available + i) % PROFILER_FRAMES];
+            samples.push_back((p < phase_count ? frame.phase_ticks[p] : frame.frame_ticks) * ms_per_tick);
+        }
+        double p50 = 0, p99 = 0, max = 0;
+        if (!samples.empty()) {
+            size_t i50 = samples.size() / 2, i99 = samples.size() * 99 / 100;
+            std::nth_element(samples.begin(), samples.begin() + i50, samples.end());
+            p50 = samples[i50];
+            std::nth_element(samples.begin(), samples.begin() + i99, samples.end());
+            p99 = samples[i99];
+            max = *std::max_element(samples.begin(), samples.end());
+        }
+        std::snprintf(text, sizeof(text), "%-10.10s %8.2f %8.2f %8.2f", p < phase_count ? names[p] : "FRAME", p50,
+                      p99, max);
+        draw_text(graph_x, y, text);
+        y += line;
+    }
+    SDL_RenderFillRects(renderer, rects.data(), (int) rects.size());
+
+    SDL_SetRenderDrawBlendMode(renderer, saved_blend);
+    SDL_SetRenderDrawColor(renderer, saved[0], saved[1], saved[2], saved[3]);
+}
+
+bool profiler_t::write_csv(const char *path) const {
+    FILE *file = std::fopen(path, "w");
+    if (!file) return false;
+    Uint64 n = frame_count.load(std::memory_order_acquire);
+    Uint64 available = std::min<Uint64>(n, PROFILER_FRAMES);
+
+    std::fprintf(file, "frame");
+    for (int p = 0; p < phase_count; p++) std::fprintf(file, ",%s_ms", names[p]);
+    std::fprintf(file, ",frame_ms\n");
+    for (Uint64 f = n - available; f < n; f++) {
+        const frame_t &frame = frames[f % PROFILER_FRAMES];
+        std::fprintf(file, "%llu", (unsigned long long) f);
+        for (int p = 0; p < phase_count; p++) std::fprintf(file, ",%.4f", frame.phase_ticks[p] * ms_per_tick);
+        std::fprintf(file, ",%.4f\n", frame.frame_ticks * ms_per_tick);
+    }
+    return std::fclose(file) == 0;
+}
+
+#endif
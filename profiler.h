@@ -0,0 +1,103 @@
+#ifndef MYGAME_PROFILER_H
+#define MYGAME_PROFILER_H
+
+#include "SDL2/SDL.h"
+#include <atomic>
+#include <vector>
+
+// Profiler klatek: czasy faz (zdarzenia, fizyka, rysowanie, ...) mierzone
+// SDL_GetPerformanceCounter i zapisywane po każdej klatce do pierścienia
+// ostatnich PROFILER_FRAMES klatek. Nakładka pokazuje wykres czasów klatek
+// i percentyle p50/p99/max każdej fazy, a pierścień można zapisać do CSV.
+//
+// Budowany tylko przy MYGAME_PROFILER=1 (opcja CMake MYGAME_PROFILER).
+// W przeciwnym razie profiler_t i profile_scope_t są pustymi klasami
+// z pustymi metodami inline i nie generują żadnego kodu.
+#define PROFILER_FRAMES 1024
+#define PROFILER_MAX_PHASES 8
+
+#if MYGAME_PROFILER
+
+class profiler_t {
+public:
+    // phase_names - nazwy faz (wielkie litery, cyfry, . : % / - _), muszą żyć
+    // tyle co profiler
+    profiler_t(const char *const *phase_names, int phase_count);
+
+    // Dolicza czas do fazy bieżącej klatki; bez blokad, z dowolnego wątku
+    void add(int phase, Uint64 ticks) {
+        accumulated[phase].fetch_add(ticks, std::memory_order_relaxed);
+    }
+
+    // Zamyka klatkę: przenosi czasy faz i czas całej klatki do pierścienia.
+    // Wywołuje jeden wątek (pętla gry), ten sam, który rysuje nakładkę i zapisuje CSV.
+    void end_frame();
+
+    // Wykres ostatnich klatek i tabela percentyli w lewym górnym rogu
+    void draw_overlay(SDL_Renderer *renderer);
+
+    // Zapis pierścienia: numer klatki, czas każdej fazy i całej klatki w ms
+    bool write_csv(const char *path) const;
+
+    bool overlay_visible = false;
+
+private:
+    struct frame_t {
+        Uint64 phase_ticks[PROFILER_MAX_PHASES];
+        Uint64 frame_ticks;
+    };
+
+    void draw_text(int x, int y, const char *text);
+
+    const char *const *names;
+    int phase_count;
+    double ms_per_tick;
+    Uint64 frame_start;
+
+    std::atomic<Uint64> accumulated[PROFILER_MAX_PHASES];
+    frame_t frames[PROFILER_FRAMES];
+    std::atomic<Uint64> frame_count{0}; // liczba zamkniętych klatek; ostatnia w frames[(n - 1) % PROFILER_FRAMES]
+
+    // Bufory nakładki, używane ponownie w każdej klatce
+    std::vector<SDL_Rect> rects;
+    std::vector<double> samples;
+    std::vector<int> stacked;
+};
+
+// Mierzy czas od utworzenia do końca zakresu i dolicza go do fazy
+class profile_scope_t {
+public:
+    profile_scope_t(profiler_t &profiler, int phase)
+            : profiler(profiler), phase(phase), start(SDL_GetPerformanceCounter()) {}
+
+    ~profile_scope_t() {
+        profiler.add(phase, SDL_GetPerformanceCounter() - start);
+    }
+
+private:
+    profiler_t &profiler;
+    int phase;
+    Uint64 start;
+};
+
+#else
+
+class profiler_t {
+public:
+    profiler_t(const char *const *, int) {}
+    void add(int, Uint64) {}
+    void end_frame() {}
+    void draw_overlay(SDL_Renderer *) {}
+    // Bez profilera nie ma czego zapisać - to nie błąd (F4, --profile-csv)
+    bool write_csv(const char *) const { return true; }
+    bool overlay_visible = false;
+};
+
+class profile_scope_t {
+public:
+    profile_scope_t(profiler_t &, int) {}
+};
+
+#endif
+
+#endif
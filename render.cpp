@@ -0,0 +1,192 @@
+#include "render.h"
+#include <algorithm>
+#include <stdexcept>
+
+std::shared_ptr<SDL_Texture> load_image(SDL_Renderer *renderer, const char *path) {
+    SDL_Surface *surface = SDL_LoadBMP(path);
+    if (!surface) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface from image: %s", SDL_GetError());
+        throw std::invalid_argument(SDL_GetError());
+    }
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (!texture) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture from surface: %s", SDL_GetError());
+        SDL_FreeSurface(surface);
+        throw std::invalid_argument(SDL_GetError());
+    }
+    std::shared_ptr<SDL_Texture> tex(texture, SDL_DestroyTexture);
+    SDL_FreeSurface(surface);
+    return tex;
+}
+
+std::vector<std::shared_ptr<SDL_Texture>> load_player_textures(SDL_Renderer *renderer) {
+    std::vector<std::shared_ptr<SDL_Texture>> textures;
+
+    SDL_Surface *surface1 = SDL_LoadBMP("Image/player.bmp");
+    if (!surface1) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface from image: %s", SDL_GetError());
+        throw std::invalid_argument(SDL_GetError());
+    }
+    SDL_SetColorKey(surface1, SDL_TRUE, SDL_MapRGB(surface1->format, 0, 255, 255));
+    SDL_Texture *texture1 = SDL_CreateTextureFromSurface(renderer, surface1);
+    if (!texture1) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture from surface: %s", SDL_GetError());
+        SDL_FreeSurface(surface1);
+        throw std::invalid_argument(SDL_GetError());
+    }
+    textures.emplace_back(texture1, SDL_DestroyTexture);
+    SDL_FreeSurface(surface1);
+
+    SDL_Surface *surface2 = SDL_LoadBMP("Image/player2.bmp");
+    if (!surface2) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface from image: %s", SDL_GetError());
+        throw std::invalid_argument(SDL_GetError());
+    }
+    SDL_SetColorKey(surface2, SDL_TRUE, SDL_MapRGB(surface2->format, 0, 255, 255));
+    SDL_Texture *texture2 = SDL_CreateTextureFromSurface(renderer, surface2);
+    if (!texture2) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture from surface: %s", SDL_GetError());
+        SDL_FreeSurface(surface2);
+        throw std::invalid_argument(SDL_GetError());
+    }
+    textures.emplace_back(texture2, SDL_DestroyTexture);
+    SDL_FreeSurface(surface2);
+
+    return textures;
+}
+
+// Rozkłada prostokąty o rozmiarach z rects półkami w obszarze o szerokości
+// width; ustawia x, y prostokątów i zwraca zajętą wysokość
+static int pack_shelves(std::vector<SDL_Rect> &rects, int width, int padding) {
+    std::vector<size_t> order(rects.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return rects[a].h > rects[b].h; });
+
+    int x = 0, y = 0, shelf_height = 0;
+    for (size_t i : order) {
+        SDL_Rect &r = rects[i];
+        if (x > 0 && x + r.w > width) {
+            y += shelf_height + padding;
+            x = 0;
+            shelf_height = 0;
+        }
+        r.x = x;
+        r.y = y;
+        x += r.w + padding;
+        shelf_height = std::max(shelf_height, r.h);
+    }
+    return y + shelf_height;
+}
+
+SDL_Surface *load_image_surface(const char *path, bool color_key) {
+    SDL_RWops *file = SDL_RWFromFile(path, "rb");
+    if (!file) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't open image: %s", SDL_GetError());
+        throw std::invalid_argument(SDL_GetError());
+    }
+    SDL_Surface *loaded = SDL_LoadBMP_RW(file, 1);
+    if (!loaded) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface from image: %s", SDL_GetError());
+        throw std::invalid_argument(SDL_GetError());
+    }
+    if (color_key) SDL_SetColorKey(loaded, SDL_TRUE, SDL_MapRGB(loaded->format, 0, 255, 255));
+    SDL_Surface *converted = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(loaded);
+    if (!converted) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert image: %s", SDL_GetError());
+        throw std::invalid_argument(SDL_GetError());
+    }
+    return converted;
+}
+
+SDL_Surface *pack_atlas_surface(const std::vector<atlas_image_t> &images, int max_size, std::vector<SDL_Rect> &rects) {
+    const int padding = 2; // odstęp chroniący przed przenikaniem sąsiadów przy filtrowaniu
+    std::vector<SDL_Surface *> surfaces;
+    auto free_surfaces = [&surfaces] {
+        for (SDL_Surface *surface : surfaces) SDL_FreeSurface(surface);
+    };
+
+    rects.clear();
+    for (const atlas_image_t &image : images) {
+        try {
+            surfaces.push_back(load_image_surface(image.path, image.color_key));
+        } catch (...) {
+            free_surfaces();
+            throw;
+        }
+        rects.push_back({0, 0, surfaces.back()->w, surfaces.back()->h});
+    }
+
+    // Najwęższy atlas (potęga dwójki), w którym obrazy mieszczą się we
+    // wierszach nie wyższych niż jego szerokość
+    int widest = 1;
+    for (const SDL_Rect &r : rects) widest = std::max(widest, r.w);
+    int width, height;
+    for (width = 64; width < widest; width *= 2) {}
+    for (;; width *= 2) {
+        height = pack_shelves(rects, width, padding);
+        if (height <= width || width >= max_size) break;
+    }
+    if (width > max_size || height > max_size) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Images don't fit in a %dx%d atlas", max_size, max_size);
+        free_surfaces();
+        throw std::invalid_argument("Images don't fit in the texture atlas");
+    }
+
+    SDL_Surface *sheet = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!sheet) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create atlas surface: %s", SDL_GetError());
+        free_surfaces();
+        throw std::invalid_argument(SDL_GetError());
+    }
+    for (size_t i = 0; i < surfaces.size(); i++) {
+        // Kopiowanie razem z kanałem alfa, bez mieszania
+        SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(surfaces[i], NULL, sheet, &rects[i]);
+    }
+    free_surfaces();
+    return sheet;
+}
+
+int max_texture_size(SDL_Renderer *renderer) {
+    SDL_RendererInfo info;
+    if (!SDL_GetRendererInfo(renderer, &info) && info.max_texture_width && info.max_texture_height) {
+        return std::min(info.max_texture_width, info.max_texture_height);
+    }
+    return 4096;
+}
+
+texture_atlas_t::texture_atlas_t(SDL_Renderer *renderer, const std::vector<atlas_image_t> &images) {
+    SDL_Surface *sheet = pack_atlas_surface(images, max_texture_size(renderer), rects);
+    width = sheet->w;
+    height = sheet->h;
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, sheet);
+    SDL_FreeSurface(sheet);
+    if (!texture) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture from surface: %s", SDL_GetError());
+        throw std::invalid_argument(SDL_GetError());
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    atlas.reset(texture, SDL_DestroyTexture);
+}
+
+void sprite_batch_t::begin(SDL_Texture *batch_texture) {
+    texture = batch_texture;
+    int w = 1, h = 1;
+    if (texture) SDL_QueryTexture(texture, NULL, NULL, &w, &h);
+    inv_width = 1.0f / (float) w;
+    inv_height = 1.0f / (float) h;
+    vertices.clear();
+    indices.clear();
+}
+
+int sprite_batch_t::flush(SDL_Renderer *renderer) {
+    int result = 0;
+    if (!indices.empty()) {
+        result = SDL_RenderGeometry(renderer, texture, vertices.data(), (int) vertices.size(), indices.data(),
+                                    (int) indices.size());
+    }
+    vertices.clear();
+    indices.clear();
+    return result;
+}
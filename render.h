@@ -0,0 +1,164 @@
+#ifndef MYGAME_RENDER_H
+#define MYGAME_RENDER_H
+
+#include "SDL2/SDL.h"
+#include "camera.h"
+#include "chunked_map.h"
+#include "game.h"
+#include "level_file.h"
+#include <memory>
+#include <vector>
+
+// Położenie grafiki kafelka w teksturze kafelków
+inline SDL_Rect tile_source_rect(const game_map_t &, int tile) {
+    return {128 * (tile - 1), 0, TILE_SIZE, TILE_SIZE};
+}
+
+inline SDL_Rect tile_source_rect(const chunked_map_t &, int tile) {
+    return {128 * (tile - 1), 0, TILE_SIZE, TILE_SIZE};
+}
+
+inline SDL_Rect tile_source_rect(const mapped_level_t &level, int tile) {
+    const level_palette_entry_t &type = level.tile_type(tile);
+    return {type.src_x, type.src_y, TILE_SIZE, TILE_SIZE};
+}
+
+// Rysowanie kafelków z prostokąta tiles przesuniętych o (offset_x,
+// offset_y) pikseli, jedno SDL_RenderCopy na kafelek
+template<class map_t>
+void draw_map_region(SDL_Renderer *renderer, const map_t &map, SDL_Texture *tex, const tile_rect_t &tiles,
+                     int offset_x, int offset_y) {
+    for (int y = tiles.y1 - 1; y >= tiles.y0; y--)
+        for (int x = tiles.x0; x < tiles.x1; x++) {
+            int tile = map.get(x, y);
+            if (tile > 0) {
+                SDL_Rect dst = {x * TILE_SIZE + offset_x, y * TILE_SIZE + offset_y, TILE_SIZE, TILE_SIZE};
+                SDL_Rect src = tile_source_rect(map, tile);
+                SDL_RenderCopy(renderer, tex, &src, &dst);
+            }
+        }
+}
+
+// Rysowanie wszystkich kafelków mapy w położeniu bezwzględnym
+template<class map_t>
+void draw_map(SDL_Renderer *renderer, const map_t &map, SDL_Texture *tex) {
+    draw_map_region(renderer, map, tex, {0, 0, map.width, map.height}, 0, 0);
+}
+
+// Rysowanie kafelków widocznych w kamerze - koszt zależy od rozmiaru
+// widoku, a nie poziomu
+template<class map_t>
+void draw_map(SDL_Renderer *renderer, const map_t &map, SDL_Texture *tex, const camera_t &camera) {
+    draw_map_region(renderer, map, tex, camera.visible_tiles(map.width, map.height), -camera.x, -camera.y);
+}
+
+std::shared_ptr<SDL_Texture> load_image(SDL_Renderer *renderer, const char *path);
+
+std::vector<std::shared_ptr<SDL_Texture>> load_player_textures(SDL_Renderer *renderer);
+
+// Obraz do umieszczenia w atlasie
+struct atlas_image_t {
+    const char *path;
+    bool color_key; // piksele (0, 255, 255) przezroczyste, jak w load_player_textures
+};
+
+// Wczytuje obraz BMP (SDL_LoadBMP_RW) i zamienia na ARGB8888, z kolorem
+// kluczowym jako kanałem alfa. Nie używa renderera, więc może działać
+// w dowolnym wątku. Rzuca std::invalid_argument.
+SDL_Surface *load_image_surface(const char *path, bool color_key);
+
+// Wczytuje obrazy i pakuje je w jedną powierzchnię ARGB8888 o boku najwyżej
+// max_size; rects - położenie kolejnych obrazów. Jak load_image_surface
+// działa w dowolnym wątku i rzuca std::invalid_argument.
+SDL_Surface *pack_atlas_surface(const std::vector<atlas_image_t> &images, int max_size, std::vector<SDL_Rect> &rects);
+
+// Największy bok tekstury obsługiwany przez renderer
+int max_texture_size(SDL_Renderer *renderer);
+
+// Wszystkie obrazy gry upakowane półkami w jedną teksturę (wiersze obrazów
+// posortowanych wg wysokości). Cała klatka rysowana z atlasu wymaga jednego
+// powiązania tekstury, więc sprite_batch_t może ją wysłać jednym wywołaniem.
+class texture_atlas_t {
+public:
+    // Rzuca std::invalid_argument, gdy obrazu nie da się wczytać albo
+    // obrazy nie mieszczą się w największej teksturze renderera
+    texture_atlas_t(SDL_Renderer *renderer, const std::vector<atlas_image_t> &images);
+
+    SDL_Texture *texture() const { return atlas.get(); }
+
+    // Położenie i-tego obrazu (w kolejności z konstruktora) w atlasie
+    const SDL_Rect &rect(int index) const { return rects[index]; }
+
+    int width = 0, height = 0;
+
+private:
+    std::shared_ptr<SDL_Texture> atlas;
+    std::vector<SDL_Rect> rects;
+};
+
+// Zbiera prostokąty (kafelki, postacie, tło) z jednej tekstury i wysyła je
+// jednym SDL_RenderGeometry. Bufory wierzchołków są używane ponownie, więc
+// po pierwszych klatkach rysowanie nie alokuje pamięci.
+class sprite_batch_t {
+public:
+    // Zaczyna nową partię dla danej tekstury (zwykle texture_atlas_t::texture())
+    void begin(SDL_Texture *texture);
+
+    // Prostokąt src tekstury narysowany w miejscu dst
+    void add(const SDL_Rect &src, const SDL_FRect &dst) {
+        int first = (int) vertices.size();
+        float u0 = src.x * inv_width, v0 = src.y * inv_height;
+        float u1 = (src.x + src.w) * inv_width, v1 = (src.y + src.h) * inv_height;
+        const SDL_Color white = {255, 255, 255, 255};
+        vertices.push_back({{dst.x, dst.y}, white, {u0, v0}});
+        vertices.push_back({{dst.x + dst.w, dst.y}, white, {u1, v0}});
+        vertices.push_back({{dst.x + dst.w, dst.y + dst.h}, white, {u1, v1}});
+        vertices.push_back({{dst.x, dst.y + dst.h}, white, {u0, v1}});
+        const int quad[6] = {0, 1, 2, 0, 2, 3};
+        for (int i : quad) indices.push_back(first + i);
+    }
+
+    // Wysyła partię; zwraca wynik SDL_RenderGeometry (0 - sukces)
+    int flush(SDL_Renderer *renderer);
+
+    int sprite_count() const { return (int) vertices.size() / 4; }
+
+private:
+    SDL_Texture *texture = nullptr;
+    float inv_width = 1, inv_height = 1;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+};
+
+// Kafelki z prostokąta region jako prostokąty partii, przesunięte o
+// (offset_x, offset_y) pikseli; tiles - położenie tekstury kafelków
+// (block.bmp) w atlasie
+template<class map_t>
+void batch_map_region(sprite_batch_t &batch, const map_t &map, const SDL_Rect &tiles, const tile_rect_t &region,
+                      int offset_x, int offset_y) {
+    for (int y = region.y1 - 1; y >= region.y0; y--)
+        for (int x = region.x0; x < region.x1; x++) {
+            int tile = map.get(x, y);
+            if (tile > 0) {
+                SDL_Rect src = tile_source_rect(map, tile);
+                src.x += tiles.x;
+                src.y += tiles.y;
+                batch.add(src, {(float) (x * TILE_SIZE + offset_x), (float) (y * TILE_SIZE + offset_y),
+                                TILE_SIZE, TILE_SIZE});
+            }
+        }
+}
+
+// Wszystkie kafelki mapy w położeniu bezwzględnym
+template<class map_t>
+void batch_map(sprite_batch_t &batch, const map_t &map, const SDL_Rect &tiles) {
+    batch_map_region(batch, map, tiles, {0, 0, map.width, map.height}, 0, 0);
+}
+
+// Kafelki widoczne w kamerze
+template<class map_t>
+void batch_map(sprite_batch_t &batch, const map_t &map, const SDL_Rect &tiles, const camera_t &camera) {
+    batch_map_region(batch, map, tiles, camera.visible_tiles(map.width, map.height), -camera.x, -camera.y);
+}
+
+#endif
@@ -0,0 +1,409 @@
+// Symulacja gry bez okna, renderera i opóźnień (mygame_sim).
+// Uruchamia tę samą fizykę i przejścia między mapami co main2.cpp,
+// sterując graczem deterministycznym skryptem wejścia wyliczanym z ziarna (biegnie
+// przez krawędzie map, więc sprawdza też przejścia),
+// albo odtwarza log wejścia nagrany w grze (mygame --record) bez limitu prędkości.
+// --rollback sprawdza, że przywrócenie zapisu stanu i ponowna symulacja daje
+// bit w bit ten sam wynik.
+// --endless przechodzi agentem nawigacji segmenty generowane w tle dla ziarna.
+#include "chunked_map.h"
+#include "cow_map.h"
+#include "determinism.h"
+#include "game.h"
+#include "input_log.h"
+#include "level_generator.h"
+#include "level_manager.h"
+#include "nav.h"
+#include "packed_map.h"
+#include "snapshot.h"
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+// Deterministyczny świat testowy dla --world: podłoga z dziurami co kilka
+// kafelków i losowe platformy, generowane niezależnie dla każdego chunka
+static void generate_chunk(uint64_t seed, int world_height, int cx, int cy, uint8_t *tiles) {
+    for (int y = 0; y < CHUNK_SIZE; y++) {
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            int wx = (cx << CHUNK_SHIFT) + x;
+            int wy = (cy << CHUNK_SHIFT) + y;
+            uint64_t h = seed ^ ((uint64_t) wx * 0x9e3779b97f4a7c15ULL) ^ ((uint64_t) wy * 0xc2b2ae3d27d4eb4fULL);
+            h = next_random(h);
+            int tile = 0;
+            if (wy == world_height - 1) tile = (h % 8) != 0;
+            else if (wy % 4 == 0) tile = (h % 16) == 0;
+            tiles[(y << CHUNK_SHIFT) | x] = (uint8_t) tile;
+        }
+    }
+}
+
+// Skrypt wejścia trybu domyślnego: gracz biegnie w kierunku direction
+// i skacze, gdy tuż przed nim jest dziura albo ściana, więc przechodzi przez
+// krawędzie map. Co pół sekundy kierunek jest losowany (w lewo 1 na 6) -
+// wtedy wraca też na poprzednią mapę. Klawisze przez apply_input, z tymi
+// samymi regułami co w grze: wciśnięcie tylko na ziemi, puszczenie zawsze
+// (inaczej gracz zresetowany przy lewej krawędzi leciałby w lewo bez końca).
+template<class map_t>
+static void runner_input(long long tick, uint64_t &random_state, int &direction, player_t &player,
+                         const map_t &map) {
+    if (tick % 30 == 0) direction = next_random(random_state) % 6 == 0 ? -1 : 1;
+    if (!is_on_the_ground(player, map)) {
+        if (player.a.v.y < 0) apply_input(player, map, INPUT_KEY_UP, false);
+        if (player.a.v.x * direction < 0) apply_input(player, map, direction > 0 ? INPUT_KEY_LEFT : INPUT_KEY_RIGHT, false);
+        return;
+    }
+    if (player.a.v.x != 2 * direction) apply_input(player, map, direction > 0 ? INPUT_KEY_RIGHT : INPUT_KEY_LEFT, true);
+    int row = floor_to_int(player.p.v.y + 0.01);
+    int ahead = floor_to_int(player.p.v.x + direction * (player_box.half_width + 0.1));
+    if (ahead >= 0 && ahead < map.width && (map.get(ahead, row) == 0 || map.get(ahead, row - 1) > 0)) {
+        apply_input(player, map, INPUT_KEY_UP, true);
+    }
+}
+
+// Odtworzenie logu wejścia na poziomach z plików, tą samą drogą co pętla gry
+// w main2.cpp. Zwraca 1, gdy trajektoria różni się od nagranej.
+static int replay(const char *log_path, const char *levels_dir) {
+    using namespace std::chrono;
+    input_log_t log;
+    std::unique_ptr<level_manager_t> levels;
+    try {
+        log = read_input_log(log_path);
+        levels.reset(new level_manager_t(find_level_files(levels_dir)));
+    } catch (const std::exception &e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 2;
+    }
+
+    player_t player = {{1, 1},
+                       {0, 0},
+                       {0, 0}};
+    const double dt = 1.0 / log.tick_rate;
+    uint64_t checksum = TRAJECTORY_HASH_START;
+    size_t next_event = 0;
+
+    steady_clock::time_point start = steady_clock::now();
+    for (long long tick = 0; tick < log.ticks; tick++) {
+        while (next_event < log.events.size() && log.events[next_event].tick == tick) {
+            const input_event_t &event = log.events[next_event++];
+            apply_input(player, *levels->current_collision(), event.key, event.pressed);
+        }
+        levels->transition(player);
+        player = update_player(player, *levels->current_collision(), dt);
+        checksum = trajectory_hash(checksum, player);
+    }
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    std::printf("ticks=%lld events=%zu seconds=%.6f ticks_per_second=%.0f\n", log.ticks, log.events.size(),
+                seconds, seconds > 0 ? log.ticks / seconds : 0.0);
+    std::printf("map=%d x=%.6f y=%.6f\n", levels->current_handle(), player.p.v.x, player.p.v.y);
+    std::printf("checksum=0x%016" PRIx64 "\n", checksum);
+    if (!log.complete) {
+        std::printf("log is truncated, recorded checksum not available\n");
+    } else if (checksum != log.checksum) {
+        std::fprintf(stderr, "trajectory differs from the recording: expected 0x%016" PRIx64 "\n", log.checksum);
+        return 1;
+    }
+    return 0;
+}
+
+// Stan symulacji --rollback: wszystko, co zmienia się między krokami, poza kafelkami map
+struct rollback_state_t {
+    player_t player;
+    int32_t map_index;
+    int32_t padding;
+    int64_t tick;
+    uint64_t random_state;
+    uint64_t checksum;
+};
+
+// Krok ze zmienną mapą: skrypt wejścia, kafelek pod graczem kruszy się co
+// 20 kroków, a co 64 kroki przełączany jest losowy kafelek czwartego wiersza
+// od dołu. Wszystko zależy tylko od stanu, więc krok jest powtarzalny.
+static void rollback_step(rollback_state_t &state, std::vector<cow_map_t *> &maps, double dt) {
+    state.map_index = level_transition(state.player, maps, state.map_index);
+    cow_map_t &map = *maps[state.map_index];
+    scripted_input(state.tick, state.random_state, state.player, map);
+    if (state.tick % 20 == 0 && is_on_the_ground(state.player, map)) {
+        int row = floor_to_int(state.player.p.v.y + 0.01);
+        if (row < map.height - 1) map.set(floor_to_int(state.player.p.v.x), row, 0);
+    }
+    if (state.tick % 64 == 0) {
+        int x = (int) (next_random(state.random_state) % (uint64_t) map.width);
+        map.set(x, map.height - 4, map.get(x, map.height - 4) > 0 ? 0 : 1);
+    }
+    state.player = update_player(state.player, map, dt);
+    state.checksum = trajectory_hash(state.checksum, state.player);
+    state.tick++;
+}
+
+// Suma kontrolna kafelków wszystkich map
+static uint64_t maps_hash(const std::vector<cow_map_t *> &maps) {
+    uint64_t hash = FNV1A_START;
+    for (const cow_map_t *map : maps) {
+        for (int y = 0; y < map->height; y++) {
+            for (int x = 0; x < map->width; x++) {
+                uint8_t tile = (uint8_t) map->get(x, y);
+                hash = fnv1a(hash, &tile, 1);
+            }
+        }
+    }
+    return hash;
+}
+
+// Symulacja z zapisem stanu przed każdym krokiem; co 3 * depth kroków stan
+// jest cofany o depth kroków i symulowany ponownie. Wynik musi być bit w bit
+// taki sam jak w przebiegu bez cofania.
+static int rollback(long long ticks, uint64_t seed, int depth) {
+    using namespace std::chrono;
+    const double dt = 1.0 / 60.0;
+    rollback_state_t start = {{{1, 1}, {0, 0}, {0, 0}}, 0, 0, 0, seed, FNV1A_START};
+
+    // Przebieg wzorcowy
+    std::vector<std::unique_ptr<cow_map_t>> reference_maps;
+    std::vector<cow_map_t *> reference;
+    for (const game_map_t *map : game_maps) {
+        reference_maps.emplace_back(new cow_map_t(*map));
+        reference.push_back(reference_maps.back().get());
+    }
+    rollback_state_t expected = start;
+    for (long long tick = 0; tick < ticks; tick++) rollback_step(expected, reference, dt);
+
+    std::vector<std::unique_ptr<cow_map_t>> owned_maps;
+    std::vector<cow_map_t *> maps;
+    for (const game_map_t *map : game_maps) {
+        owned_maps.emplace_back(new cow_map_t(*map));
+        maps.push_back(owned_maps.back().get());
+    }
+    snapshot_ring_t<rollback_state_t> ring(depth, maps);
+    rollback_state_t state = start;
+    long long saves = 0, restores = 0, mismatches = 0;
+    steady_clock::duration save_time{}, restore_time{};
+
+    while (state.tick < ticks) {
+        steady_clock::time_point t0 = steady_clock::now();
+        ring.save(state);
+        save_time += steady_clock::now() - t0;
+        saves++;
+        rollback_step(state, maps, dt);
+
+        if (state.tick % (3 * depth) == 0 && ring.size() == depth) {
+            const rollback_state_t before = state;
+            const uint64_t before_maps = maps_hash(maps);
+            t0 = steady_clock::now();
+            ring.restore(depth - 1, state);
+            restore_time += steady_clock::now() - t0;
+            restores++;
+            // Przywrócony zapis zostaje w pierścieniu; kolejne kroki zapisują się jak zwykle
+            for (int i = 0; i < depth; i++) {
+                if (i > 0) ring.save(state);
+                rollback_step(state, maps, dt);
+            }
+            if (std::memcmp(&before, &state, sizeof(state)) != 0 || maps_hash(maps) != before_maps) mismatches++;
+        }
+    }
+
+    size_t pool_blocks = 0, map_blocks = 0;
+    for (const cow_map_t *map : maps) {
+        pool_blocks += map->pool_blocks();
+        map_blocks += (size_t) map->block_count();
+    }
+    std::printf("ticks=%lld depth=%d saves=%lld restores=%lld snapshot_bytes=%zu\n", ticks, depth, saves, restores,
+                ring.snapshot_bytes());
+    std::printf("save_us=%.3f restore_us=%.3f map_blocks=%zu pool_blocks=%zu\n",
+                saves ? duration<double, std::micro>(save_time).count() / saves : 0.0,
+                restores ? duration<double, std::micro>(restore_time).count() / restores : 0.0, map_blocks,
+                pool_blocks);
+    std::printf("checksum=0x%016" PRIx64 " maps=0x%016" PRIx64 "\n", state.checksum, maps_hash(maps));
+    if (mismatches || std::memcmp(&expected, &state, sizeof(state)) != 0 || maps_hash(maps) != maps_hash(reference)) {
+        std::fprintf(stderr, "rollback diverged: %lld resimulations differ, expected checksum 0x%016" PRIx64 "\n",
+                     mismatches, expected.checksum);
+        return 1;
+    }
+    return 0;
+}
+
+// Segmenty z level_stream_t przechodzone agentem nawigacji: po dojściu do
+// ostatniej kolumny agent idzie w prawo, a wyjście za prawą krawędź
+// zabiera następny segment i resetuje gracza (jak level_transition).
+// Segment, którego agent nie przejdzie w minutę gry, liczy się jako porażka.
+static int endless(long long segments, uint64_t seed, bool check, uint64_t expected) {
+    using namespace std::chrono;
+    const double dt = 1.0 / 60.0;
+    const long long max_ticks = 60 * 60;
+    const player_t start_player = {{1, 1}, {0, 0}, {0, 0}};
+
+    level_stream_t stream(seed);
+    nav_query_t query;
+    player_t player = start_player;
+    uint64_t checksum = FNV1A_START;
+    long long ticks = 0, failures = 0, attempts = 0;
+    steady_clock::duration handoff_time{};
+
+    steady_clock::time_point start = steady_clock::now();
+    for (long long done = 0; done < segments; done++) {
+        steady_clock::time_point t0 = steady_clock::now();
+        std::unique_ptr<generated_level_t> level = stream.next();
+        handoff_time += steady_clock::now() - t0;
+        attempts += level->attempts;
+        checksum = fnv1a(checksum, level->map.map.data(), level->map.map.size() * sizeof(int));
+
+        const packed_map_t &map = level->collision;
+        nav_agent_t agent;
+        long long tick = 0;
+        for (; tick < max_ticks && player.p.v.x < map.width; tick++) {
+            if (player.p.v.x < 0) reset_player(player);
+            if (is_on_the_ground(player, map) &&
+                level->navigation.cell_at(player.p.v.x, player.p.v.y, 0) == level->exit_cell) {
+                apply_input(player, map, INPUT_KEY_UP, false);
+                apply_input(player, map, INPUT_KEY_RIGHT, true);
+            } else {
+                agent.control(player, map, level->navigation, query, level->exit_cell);
+            }
+            player = update_player(player, map, dt);
+            checksum = trajectory_hash(checksum, player);
+        }
+        ticks += tick;
+        if (player.p.v.x < map.width) failures++;
+        player = start_player;
+    }
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    std::printf("segments=%lld ticks=%lld seconds=%.6f segments_per_second=%.0f\n", segments, ticks, seconds,
+                seconds > 0 ? segments / seconds : 0.0);
+    std::printf("stalls=%lld handoff_us=%.3f attempts_per_segment=%.2f failures=%lld\n", stream.stalls,
+                segments ? duration<double, std::micro>(handoff_time).count() / segments : 0.0,
+                segments ? (double) attempts / segments : 0.0, failures);
+    std::printf("checksum=0x%016" PRIx64 "\n", checksum);
+    if (check && checksum != expected) {
+        std::fprintf(stderr, "checksum mismatch: expected 0x%016" PRIx64 "\n", expected);
+        return 1;
+    }
+    return 0;
+}
+
+static void usage(const char *name) {
+    std::printf("usage: %s [--ticks N] [--seed S] [--expect CHECKSUM] [--world WIDTHxHEIGHT]\n"
+                "       %s --replay INPUT_LOG [--levels DIR]\n"
+                "       %s --rollback DEPTH [--ticks N] [--seed S]\n"
+                "       %s --endless SEGMENTS [--seed S] [--expect CHECKSUM]\n", name, name, name, name);
+}
+
+int main(int argc, char *argv[]) {
+    using namespace std::chrono;
+
+    long long ticks = 1000000;
+    uint64_t seed = 1;
+    bool check = false;
+    uint64_t expected = 0;
+    int world_width = 0, world_height = 0;
+    const char *replay_path = nullptr;
+    const char *levels_dir = "levels";
+    bool rollback_mode = false, endless_mode = false;
+    int rollback_depth = 0;
+    long long endless_segments = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--ticks") && i + 1 < argc) {
+            ticks = std::atoll(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 0);
+        } else if (!std::strcmp(argv[i], "--expect") && i + 1 < argc) {
+            expected = std::strtoull(argv[++i], nullptr, 0);
+            check = true;
+        } else if (!std::strcmp(argv[i], "--world") && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%dx%d", &world_width, &world_height) != 2 ||
+                world_width <= 0 || world_height <= 0) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if (!std::strcmp(argv[i], "--replay") && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--levels") && i + 1 < argc) {
+            levels_dir = argv[++i];
+        } else if (!std::strcmp(argv[i], "--rollback") && i + 1 < argc) {
+            rollback_depth = std::atoi(argv[++i]);
+            rollback_mode = true;
+        } else if (!std::strcmp(argv[i], "--endless") && i + 1 < argc) {
+            endless_segments = std::atoll(argv[++i]);
+            endless_mode = true;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if ((rollback_mode && rollback_depth <= 0) || (endless_mode && endless_segments <= 0)) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (replay_path) return replay(replay_path, levels_dir);
+    if (seed == 0) seed = 1; // xorshift nie może startować od zera
+    if (rollback_mode) return rollback(ticks, seed, rollback_depth);
+    if (endless_mode) return endless(endless_segments, seed, check, expected);
+
+    player_t player = {{1, 1},
+                       {0, 0},
+                       {0, 0}};
+    double dt = 1.0 / 60.0;
+    game_map_t *current_map = &game_map1;
+
+    uint64_t random_state = seed;
+    uint64_t checksum = FNV1A_START;
+    long long map_changes = 0;
+
+    steady_clock::time_point start = steady_clock::now();
+    if (world_width > 0) {
+        // Jeden duży świat wczytywany chunkami wokół gracza
+        chunked_map_t world(world_width, world_height, [seed, world_height](int cx, int cy, uint8_t *tiles) {
+            generate_chunk(seed, world_height, cx, cy, tiles);
+        });
+        for (long long tick = 0; tick < ticks; tick++) {
+            if (player.p.v.x < 0 || player.p.v.x >= world.width) reset_player(player);
+            world.stream_around(player.p.v.x, player.p.v.y);
+            scripted_input(tick, random_state, player, world);
+            player = update_player(player, world, dt);
+            checksum = trajectory_hash(checksum, player);
+        }
+        double seconds = duration<double>(steady_clock::now() - start).count();
+        std::printf("ticks=%lld seconds=%.6f ticks_per_second=%.0f\n", ticks, seconds,
+                    seconds > 0 ? ticks / seconds : 0.0);
+        std::printf("world=%dx%d resident_chunks=%zu memory_bytes=%zu loads=%lld evictions=%lld\n",
+                    world.width, world.height, world.resident_chunks(), world.memory_bytes(),
+                    world.loads, world.evictions);
+    } else {
+        // Fizyka na zwartych mapach kolizji, przejścia na mapach wkompilowanych
+        std::vector<packed_map_t> packed_maps;
+        for (game_map_t *map : game_maps) packed_maps.emplace_back(*map);
+        int direction = 1;
+        for (long long tick = 0; tick < ticks; tick++) {
+            game_map_t *previous_map = current_map;
+            current_map = update_map_transition(player);
+            if (current_map != previous_map) map_changes++;
+            const packed_map_t &collision = packed_maps[current_map_index];
+            runner_input(tick, random_state, direction, player, collision);
+            player = update_player(player, collision, dt);
+            checksum = trajectory_hash(checksum, player);
+        }
+        double seconds = duration<double>(steady_clock::now() - start).count();
+        std::printf("ticks=%lld seconds=%.6f ticks_per_second=%.0f\n", ticks, seconds,
+                    seconds > 0 ? ticks / seconds : 0.0);
+        std::printf("map=%d map_changes=%lld\n", current_map_index, map_changes);
+        // Pierwsze przejście jest po kilkunastu sekundach gry; dłuższy przebieg
+        // bez przejść nie sprawdza update_map_transition
+        if (ticks >= 60 * 60 && map_changes == 0) {
+            std::fprintf(stderr, "no map transitions in %lld ticks\n", ticks);
+            return 1;
+        }
+    }
+    std::printf("x=%.6f y=%.6f\n", player.p.v.x, player.p.v.y);
+    std::printf("checksum=0x%016" PRIx64 "\n", checksum);
+
+    if (check && checksum != expected) {
+        std::fprintf(stderr, "checksum mismatch: expected 0x%016" PRIx64 "\n", expected);
+        return 1;
+    }
+    return 0;
+}
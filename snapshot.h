@@ -0,0 +1,122 @@
+#ifndef MYGAME_SNAPSHOT_H
+#define MYGAME_SNAPSHOT_H
+
+#include "cow_map.h"
+#include "game.h"
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Cały stan rozgrywki z pętli gry (main2.cpp) w jednej strukturze POD -
+// zamiast zmiennych lokalnych i globalnych (current_map_index), więc zapis
+// i przywrócenie stanu to skopiowanie kilkuset bajtów
+struct game_state_t {
+    player_t player;
+    player_t previous_player;     // stan z poprzedniego kroku (do interpolacji)
+    int32_t map_index;            // uchwyt poziomu w level_manager_t
+    int32_t player_frame_counter; // kroki od ostatniej zmiany klatki animacji
+    int32_t player_texture1;      // klatka animacji gracza
+    int32_t padding;
+    int64_t tick;
+    uint64_t trajectory;          // suma kontrolna trajektorii (trajectory_hash)
+};
+
+// Pierścień ostatnich capacity zapisów stanu do cofania czasu, powtórek
+// i rollbacku. Zapis to kopia struktury POD state_t oraz numery bloków
+// zmiennych map (cow_map_t) - kafelki są współdzielone z mapą, dopóki nie
+// zostaną zmienione. Cała pamięć jest przydzielana w konstruktorze: save()
+// i restore() nie alokują (poza kopiowaniem bloku w cow_map_t::set).
+template<class state_t>
+class snapshot_ring_t {
+    static_assert(std::is_trivially_copyable<state_t>::value, "snapshot state must be a POD");
+
+public:
+    // maps - zmienne mapy zapisywane razem ze stanem; muszą żyć dłużej niż pierścień
+    explicit snapshot_ring_t(int capacity, std::vector<cow_map_t *> maps = {})
+            : maps(std::move(maps)), states((size_t) (capacity > 0 ? capacity : 1)) {
+        for (cow_map_t *map : this->maps) blocks_per_snapshot += (size_t) map->block_count();
+        block_ids.resize(states.size() * blocks_per_snapshot);
+    }
+
+    ~snapshot_ring_t() {
+        while (count > 0) drop_newest();
+    }
+
+    snapshot_ring_t(const snapshot_ring_t &) = delete;
+    snapshot_ring_t &operator=(const snapshot_ring_t &) = delete;
+
+    int size() const { return count; }
+    int capacity() const { return (int) states.size(); }
+
+    // Bajty jednego zapisu (stan i numery bloków, bez współdzielonych kafelków)
+    size_t snapshot_bytes() const { return sizeof(state_t) + blocks_per_snapshot * sizeof(int32_t); }
+
+    // Zapisuje stan; przy pełnym pierścieniu zastępuje najstarszy zapis
+    void save(const state_t &state) {
+        if (count == capacity()) {
+            release(first);
+            first = (first + 1) % capacity();
+            count--;
+        }
+        int slot = (first + count) % capacity();
+        states[slot] = state;
+        int32_t *ids = slot_ids(slot);
+        for (cow_map_t *map : maps) {
+            map->capture(ids);
+            ids += map->block_count();
+        }
+        count++;
+    }
+
+    // Przywraca stan sprzed age zapisów (0 - ostatni) razem z zawartością
+    // map i usuwa nowsze zapisy, więc symulacja może iść dalej od tego
+    // miejsca. Zwraca false, gdy tylu zapisów nie ma.
+    bool restore(int age, state_t &state) {
+        if (age < 0 || age >= count) return false;
+        while (age-- > 0) drop_newest();
+        int slot = (first + count - 1) % capacity();
+        state = states[slot];
+        const int32_t *ids = slot_ids(slot);
+        for (cow_map_t *map : maps) {
+            map->restore(ids);
+            ids += map->block_count();
+        }
+        return true;
+    }
+
+    // Zapis sprzed age zapisów bez przywracania; nullptr, gdy tylu zapisów nie ma
+    const state_t *peek(int age) const {
+        if (age < 0 || age >= count) return nullptr;
+        return &states[(first + count - 1 - age) % capacity()];
+    }
+
+    void clear() {
+        while (count > 0) drop_newest();
+        first = 0;
+    }
+
+private:
+    std::vector<cow_map_t *> maps;
+    std::vector<state_t> states;
+    std::vector<int32_t> block_ids; // blocks_per_snapshot na zapis
+    size_t blocks_per_snapshot = 0;
+    int first = 0; // najstarszy zapis
+    int count = 0;
+
+    int32_t *slot_ids(int slot) { return block_ids.data() + (size_t) slot * blocks_per_snapshot; }
+
+    void release(int slot) {
+        const int32_t *ids = slot_ids(slot);
+        for (cow_map_t *map : maps) {
+            map->release(ids);
+            ids += map->block_count();
+        }
+    }
+
+    void drop_newest() {
+        release((first + count - 1) % capacity());
+        count--;
+    }
+};
+
+#endif
@@ -0,0 +1,68 @@
+#include "spatial_hash.h"
+#include <stdexcept>
+
+spatial_hash_t::spatial_hash_t(float cell_size) : inv_cell_size(1.0f / cell_size) {
+    if (!(cell_size > 0)) throw std::invalid_argument("Cell size must be positive");
+    rehash(64);
+}
+
+void spatial_hash_t::clear() {
+    for (int32_t &head : heads) head = -1;
+    tracked = 0;
+}
+
+void spatial_hash_t::link(int i) {
+    unsigned s = slot(cell_x[i], cell_y[i]);
+    prev[i] = -1;
+    next[i] = heads[s];
+    if (heads[s] >= 0) prev[heads[s]] = i;
+    heads[s] = i;
+}
+
+void spatial_hash_t::unlink(int i) {
+    if (prev[i] >= 0) next[prev[i]] = next[i];
+    else heads[slot(cell_x[i], cell_y[i])] = next[i];
+    if (next[i] >= 0) prev[next[i]] = prev[i];
+}
+
+void spatial_hash_t::rehash(size_t table_size) {
+    heads.assign(table_size, -1);
+    mask = (unsigned) table_size - 1;
+    for (int i = 0; i < tracked; i++) link(i);
+}
+
+void spatial_hash_t::update(const entity_store_t &store) {
+    relinked = 0;
+
+    // Obiekty usunięte od poprzedniego wywołania
+    for (int i = store.count; i < tracked; i++) unlink(i);
+    if (tracked > store.count) tracked = store.count;
+
+    if ((size_t) store.count > next.size()) {
+        size_t size = store.x.size();
+        next.resize(size);
+        prev.resize(size);
+        cell_x.resize(size);
+        cell_y.resize(size);
+    }
+    // Średnio najwyżej pół obiektu na kubełek
+    if ((size_t) store.count * 2 > heads.size()) {
+        size_t table_size = heads.size();
+        while ((size_t) store.count * 2 > table_size) table_size *= 2;
+        rehash(table_size);
+    }
+
+    for (int i = 0; i < store.count; i++) {
+        int cx = cell_of(store.x[i]);
+        int cy = cell_of(store.y[i]);
+        if (i < tracked) {
+            if (cell_x[i] == cx && cell_y[i] == cy) continue;
+            unlink(i);
+        }
+        cell_x[i] = cx;
+        cell_y[i] = cy;
+        link(i);
+        relinked++;
+    }
+    tracked = store.count;
+}
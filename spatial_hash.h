@@ -0,0 +1,130 @@
+#ifndef MYGAME_SPATIAL_HASH_H
+#define MYGAME_SPATIAL_HASH_H
+
+#include "entities.h"
+#include <cstdint>
+#include <vector>
+
+// Faza szeroka kolizji obiekt-obiekt: równomierna siatka komórek o boku
+// jednego kafelka (TILE_SIZE pikseli, 1.0 w jednostkach mapy), adresowana
+// haszem współrzędnych komórki. Obiekt należy do komórki, w której leży jego
+// pozycja (środek dolnej krawędzi); zapytania poszerzają zakres o prostokąt
+// kolizji, więc wyniki są dokładne.
+//
+// Kubełki to listy dwukierunkowe zapisane w tablicach indeksowanych numerem
+// obiektu (next/prev), a tablica głów ma rozmiar potęgi dwójki. update()
+// przepina tylko obiekty, które zmieniły komórkę, i nie alokuje pamięci, póki
+// liczba obiektów nie przekroczy dotychczasowego maksimum.
+struct spatial_hash_t {
+    explicit spatial_hash_t(float cell_size = 1.0f);
+
+    // Uaktualnia siatkę do bieżących pozycji obiektów. Obsługuje też obiekty
+    // dodane i usunięte (entity_store_t::remove zmienia indeksy) od
+    // poprzedniego wywołania.
+    void update(const entity_store_t &store);
+
+    void clear();
+
+    // Wywołuje fn(i, j), i < j, dla każdej pary obiektów o nachodzących na
+    // siebie prostokątach kolizji. Musi być wywołane po update().
+    template<class fn_t>
+    void for_each_pair(const entity_store_t &store, fn_t fn) const;
+
+    // Wywołuje fn(i) dla obiektów, których prostokąt nachodzi na prostokąt
+    // x0..x1, y0..y1
+    template<class fn_t>
+    void query_rect(const entity_store_t &store, float x0, float y0, float x1, float y1, fn_t fn) const;
+
+    // Wywołuje fn(i) dla obiektów, których prostokąt jest w odległości co
+    // najwyżej radius od punktu (x, y)
+    template<class fn_t>
+    void query_radius(const entity_store_t &store, float x, float y, float radius, fn_t fn) const;
+
+    int relinked = 0; // ile obiektów zmieniło komórkę w ostatnim update()
+
+private:
+    float inv_cell_size;
+    unsigned mask = 0;
+    std::vector<int32_t> heads;          // pierwszy obiekt w kubełku, -1 - pusty
+    std::vector<int32_t> next, prev;     // sąsiedzi na liście kubełka
+    std::vector<int32_t> cell_x, cell_y; // komórka, w której obiekt jest zapisany
+    int tracked = 0;                     // liczba obiektów zapisanych w siatce
+
+    int cell_of(float v) const {
+        return floor_to_int((double) v * inv_cell_size);
+    }
+
+    unsigned slot(int cx, int cy) const {
+        return ((unsigned) cx * 73856093u ^ (unsigned) cy * 19349663u) & mask;
+    }
+
+    void link(int i);
+    void unlink(int i);
+    void rehash(size_t table_size);
+
+    // fn(k) dla każdego obiektu z komórek cx0..cx1, cy0..cy1
+    template<class fn_t>
+    void for_each_in_cells(int cx0, int cy0, int cx1, int cy1, fn_t fn) const;
+};
+
+template<class fn_t>
+void spatial_hash_t::for_each_in_cells(int cx0, int cy0, int cx1, int cy1, fn_t fn) const {
+    // Zakres większy niż liczba obiektów - taniej przejrzeć wszystkie
+    long long cells = ((long long) cx1 - cx0 + 1) * ((long long) cy1 - cy0 + 1);
+    if (cells > tracked) {
+        for (int k = 0; k < tracked; k++) {
+            if (cell_x[k] >= cx0 && cell_x[k] <= cx1 && cell_y[k] >= cy0 && cell_y[k] <= cy1) fn(k);
+        }
+        return;
+    }
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            // W jednym kubełku mogą być obiekty z różnych komórek
+            for (int k = heads[slot(cx, cy)]; k >= 0; k = next[k]) {
+                if (cell_x[k] == cx && cell_y[k] == cy) fn(k);
+            }
+        }
+    }
+}
+
+template<class fn_t>
+void spatial_hash_t::for_each_pair(const entity_store_t &store, fn_t fn) const {
+    const float w = (float) (2 * store.box.half_width);
+    const float h = (float) store.box.height;
+    for (int i = 0; i < tracked; i++) {
+        const float xi = store.x[i], yi = store.y[i];
+        for_each_in_cells(cell_of(xi - w), cell_of(yi - h), cell_of(xi + w), cell_of(yi + h), [&](int j) {
+            if (j <= i) return;
+            float dx = store.x[j] - xi, dy = store.y[j] - yi;
+            if (dx < w && dx > -w && dy < h && dy > -h) fn(i, j);
+        });
+    }
+}
+
+template<class fn_t>
+void spatial_hash_t::query_rect(const entity_store_t &store, float x0, float y0, float x1, float y1, fn_t fn) const {
+    const float hw = (float) store.box.half_width;
+    const float h = (float) store.box.height;
+    for_each_in_cells(cell_of(x0 - hw), cell_of(y0), cell_of(x1 + hw), cell_of(y1 + h), [&](int k) {
+        float x = store.x[k], y = store.y[k];
+        if (x - hw < x1 && x + hw > x0 && y - h < y1 && y > y0) fn(k);
+    });
+}
+
+template<class fn_t>
+void spatial_hash_t::query_radius(const entity_store_t &store, float x, float y, float radius, fn_t fn) const {
+    const float hw = (float) store.box.half_width;
+    const float h = (float) store.box.height;
+    const float r2 = radius * radius;
+    for_each_in_cells(cell_of(x - radius - hw), cell_of(y - radius), cell_of(x + radius + hw), cell_of(y + radius + h),
+                      [&](int k) {
+                          // Najbliższy punkt prostokąta obiektu
+                          float ex = store.x[k], ey = store.y[k];
+                          float cx = x < ex - hw ? ex - hw : (x > ex + hw ? ex + hw : x);
+                          float cy = y < ey - h ? ey - h : (y > ey ? ey : y);
+                          float dx = x - cx, dy = y - cy;
+                          if (dx * dx + dy * dy <= r2) fn(k);
+                      });
+}
+
+#endif
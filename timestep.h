@@ -0,0 +1,48 @@
+#ifndef MYGAME_TIMESTEP_H
+#define MYGAME_TIMESTEP_H
+
+#include "game.h"
+#include <cmath>
+
+// Akumulator czasu dla pętli ze stałym krokiem fizyki.
+// Renderowanie odbywa się z dowolną częstotliwością, a fizyka wykonuje tyle
+// kroków dt, ile zmieściło się w czasie, który upłynął od poprzedniej klatki.
+struct fixed_timestep_t {
+    double dt;          // długość kroku fizyki w sekundach
+    int max_catch_up;   // maksymalna liczba kroków nadrabianych w jednej klatce
+    double accumulator;
+    long long dropped_steps; // kroki pominięte po przekroczeniu max_catch_up
+
+    fixed_timestep_t(double tick_rate, int max_steps)
+            : dt(1.0 / tick_rate), max_catch_up(max_steps), accumulator(0), dropped_steps(0) {}
+
+    // Dodaje czas klatki i zwraca liczbę kroków fizyki do wykonania.
+    // Jeśli zaległość przekracza max_catch_up kroków, nadmiar czasu jest
+    // odrzucany, żeby po zacięciu gra nie wpadła w spiralę nadrabiania.
+    int advance(double frame_time) {
+        accumulator += frame_time;
+        int steps = (int) (accumulator / dt);
+        if (steps > max_catch_up) {
+            dropped_steps += steps - max_catch_up;
+            steps = max_catch_up;
+            accumulator = std::fmod(accumulator, dt);
+        } else {
+            accumulator -= steps * dt;
+        }
+        return steps;
+    }
+
+    // Ułamek kroku, który upłynął od ostatniego stanu fizyki (0..1)
+    double alpha() const {
+        return accumulator / dt;
+    }
+};
+
+// Interpolacja stanu gracza pomiędzy dwoma ostatnimi krokami fizyki
+inline player_t interpolate_player(const player_t &previous, const player_t &current, double alpha) {
+    player_t ret = current;
+    ret.p = previous.p * (1.0 - alpha) + current.p * alpha;
+    return ret;
+}
+
+#endif
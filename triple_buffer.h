@@ -0,0 +1,51 @@
+#ifndef MYGAME_TRIPLE_BUFFER_H
+#define MYGAME_TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// Potrójny bufor bez blokad dla jednego pisarza i jednego czytelnika.
+// Pisarz wypełnia swój bufor i publikuje go zamianą z buforem środkowym,
+// czytelnik zabiera środkowy w zamian za swój. Żadna ze stron nie czeka na
+// drugą: pisarz zawsze ma wolny bufor, a czytelnik dostaje najnowszy
+// opublikowany stan (pośrednie stany, których nie zdążył odebrać, przepadają).
+template<class T>
+class triple_buffer_t {
+public:
+    explicit triple_buffer_t(const T &initial = T()) : buffers{initial, initial, initial} {}
+
+    triple_buffer_t(const triple_buffer_t &) = delete;
+    triple_buffer_t &operator=(const triple_buffer_t &) = delete;
+
+    // Pisarz: bufor do wypełnienia (zawartość sprzed dwóch publikacji albo
+    // oddana przez czytelnika - trzeba ustawić wszystkie pola)
+    T &write_buffer() { return buffers[back]; }
+
+    // Pisarz: udostępnia czytelnikowi write_buffer()
+    void publish() {
+        unsigned previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+        back = previous & INDEX;
+    }
+
+    // Czytelnik: pobiera najnowszy opublikowany bufor; false, gdy od
+    // poprzedniego wywołania nic nie zostało opublikowane
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        unsigned previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & INDEX;
+        return true;
+    }
+
+    // Czytelnik: bufor pobrany ostatnim update()
+    const T &read_buffer() const { return buffers[front]; }
+
+private:
+    enum : unsigned { INDEX = 3, FRESH = 4 };
+
+    T buffers[3];
+    // Indeks bufora środkowego i bit FRESH; pola stron w osobnych liniach pamięci podręcznej
+    alignas(64) std::atomic<unsigned> middle{1};
+    alignas(64) unsigned back = 2; // tylko pisarz
+    alignas(64) unsigned front = 0; // tylko czytelnik
+};
+
+#endif
@@ -0,0 +1,59 @@
+#include "worker_pool.h"
+
+worker_pool_t::worker_pool_t(int threads) {
+    if (threads <= 0) threads = (int) std::thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+    for (int i = 1; i < threads; i++) workers.emplace_back(&worker_pool_t::worker_loop, this);
+}
+
+worker_pool_t::~worker_pool_t() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    start_cv.notify_all();
+    for (std::thread &worker : workers) worker.join();
+}
+
+void worker_pool_t::work() {
+    for (;;) {
+        size_t begin = next.fetch_add(grain);
+        if (begin >= count) return;
+        size_t end = begin + grain < count ? begin + grain : count;
+        (*job)(begin, end);
+    }
+}
+
+void worker_pool_t::run(size_t item_count, size_t item_grain, const std::function<void(size_t, size_t)> &item_job) {
+    if (item_count == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &item_job;
+        count = item_count;
+        grain = item_grain > 0 ? item_grain : 1;
+        next.store(0);
+        active = (int) workers.size();
+        generation++;
+    }
+    start_cv.notify_all();
+    work();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [this] { return active == 0; });
+    job = nullptr;
+}
+
+void worker_pool_t::worker_loop() {
+    unsigned seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start_cv.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        work();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--active == 0) done_cv.notify_one();
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef MYGAME_WORKER_POOL_H
+#define MYGAME_WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Stała pula wątków do równoległych pętli. run() dzieli zakres 0..count na
+// kawałki po grain elementów, które wątki (razem z wywołującym) pobierają
+// atomowym licznikiem, i wraca po przetworzeniu całego zakresu.
+class worker_pool_t {
+public:
+    // threads - łączna liczba wątków roboczych razem z wywołującym;
+    // 0 oznacza std::thread::hardware_concurrency()
+    explicit worker_pool_t(int threads = 0);
+    ~worker_pool_t();
+
+    worker_pool_t(const worker_pool_t &) = delete;
+    worker_pool_t &operator=(const worker_pool_t &) = delete;
+
+    int size() const { return (int) workers.size() + 1; }
+
+    // Wywołuje job(begin, end) dla rozłącznych kawałków zakresu 0..count.
+    // Nie może być wywoływane jednocześnie z kilku wątków.
+    void run(size_t count, size_t grain, const std::function<void(size_t, size_t)> &job);
+
+private:
+    void worker_loop();
+    void work();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    unsigned generation = 0; // numer bieżącego run(), budzi wątki
+    int active = 0;          // wątki, które jeszcze nie skończyły bieżącego run()
+    bool stopping = false;
+
+    const std::function<void(size_t, size_t)> *job = nullptr;
+    size_t count = 0;
+    size_t grain = 1;
+    std::atomic<size_t> next{0}; // początek następnego kawałka do pobrania
+};
+
+#endif
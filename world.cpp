@@ -0,0 +1,15 @@
+#include "world.h"
+
+world_levels_t make_builtin_levels() {
+    world_levels_t levels;
+    for (const game_map_t *map : game_maps) levels.maps.emplace_back(*map);
+    return levels;
+}
+
+world_t make_world(const world_levels_t &levels) {
+    world_t world = {&levels, {}, 0, 0};
+    reset_player(world.player);
+    world.player.a.v.x = 0;
+    world.player.a.v.y = 0;
+    return world;
+}
@@ -0,0 +1,67 @@
+#ifndef MYGAME_WORLD_H
+#define MYGAME_WORLD_H
+
+#include "game.h"
+#include "packed_map.h"
+#include "worker_pool.h"
+#include <vector>
+
+// Zestaw poziomów współdzielony przez wiele światów. Po zbudowaniu jest
+// tylko czytany, więc światy w różnych wątkach nie muszą się synchronizować.
+struct world_levels_t {
+    std::vector<packed_map_t> maps;
+
+    int size() const { return (int) maps.size(); }
+    const packed_map_t *operator[](int index) const { return &maps[index]; }
+};
+
+// Warstwy kolizji map wkompilowanych w program (game_maps)
+world_levels_t make_builtin_levels();
+
+// Kompletny stan jednej rozgrywki: gracz i bieżący poziom. W przeciwieństwie
+// do current_map_index i game_maps nic tu nie jest globalne, więc dowolnie
+// wiele światów może być krokowanych niezależnie, także równolegle.
+struct world_t {
+    const world_levels_t *levels;
+    player_t player;
+    int map_index;
+    long long tick;
+
+    const packed_map_t &map() const { return levels->maps[map_index]; }
+};
+
+// Świat na początku pierwszego poziomu
+world_t make_world(const world_levels_t &levels);
+
+// Jeden krok gry: przejście między poziomami, potem fizyka gracza - to samo,
+// co robi pętla w main2.cpp
+inline void step_world(world_t &world, double dt) {
+    world.map_index = level_transition(world.player, *world.levels, world.map_index);
+    world.player = update_player(world.player, world.map(), dt);
+    world.tick++;
+}
+
+// Krokuje wszystkie światy o ticks kroków, rozdzielając je między wątki puli.
+// Przed każdym krokiem wywoływane jest control(world, index) - tam sterujący
+// (skrypt, agent) ustawia wejście gracza. control jest wołane równolegle dla
+// różnych światów, więc może zmieniać tylko stan świata o danym indeksie.
+template<class control_t>
+void step_worlds(worker_pool_t &pool, std::vector<world_t> &worlds, int ticks, double dt, control_t control) {
+    // Każdy wątek przechodzi wszystkie kroki swoich światów naraz - stan
+    // świata zostaje w pamięci podręcznej rdzenia
+    pool.run(worlds.size(), 16, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            world_t &world = worlds[i];
+            for (int t = 0; t < ticks; t++) {
+                control(world, i);
+                step_world(world, dt);
+            }
+        }
+    });
+}
+
+inline void step_worlds(worker_pool_t &pool, std::vector<world_t> &worlds, int ticks, double dt) {
+    step_worlds(pool, worlds, ticks, dt, [](world_t &, size_t) {});
+}
+
+#endif